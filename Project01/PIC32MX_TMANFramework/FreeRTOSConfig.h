@@ -66,7 +66,10 @@
 #define configUSE_COUNTING_SEMAPHORES			1
 #define configGENERATE_RUN_TIME_STATS			0
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configSUPPORT_STATIC_ALLOCATION         1
 #define configUSE_TIME_SLICING                  0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS	1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	3
 //#define configUSE_TICKLESS_IDLE                 0
 
 /* Co-routine definitions. */
@@ -89,6 +92,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend				1
 #define INCLUDE_vTaskDelayUntil				1
 #define INCLUDE_vTaskDelay					1
+#define INCLUDE_xTaskAbortDelay				1
 #define INCLUDE_uxTaskGetStackHighWaterMark	1
 #define INCLUDE_eTaskGetState				1
 #define INCLUDE_xTaskGetHandle              1
@@ -97,6 +101,12 @@ to exclude the API function. */
 #ifndef __LANGUAGE_ASSEMBLY
 	void vAssertCalled( const char *pcFileName, unsigned long ulLine );
 	#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+	/* TMAN measures the CPU time of every job across context switches. */
+	void TMAN_TraceSwitchedIn( void );
+	void TMAN_TraceSwitchedOut( void );
+	#define traceTASK_SWITCHED_IN()		TMAN_TraceSwitchedIn()
+	#define traceTASK_SWITCHED_OUT()	TMAN_TraceSwitchedOut()
 #endif
 
 /* The priority at which the tick interrupt runs.  This should probably be
@@ -26,18 +26,33 @@
 /* App includes */
 #include "../UART/uart.h"
 #include "tman.h"
+#include "tmantaskset.h"
 
 /* Number of iterations of each for cycle */
 #define IMAXCOUNT                   90
 #define JMAXCOUNT                   15
 /* Framework configuration parameters */
 #define TMAN_TICK                   200
-#define TMAN_NUMBER_TASK            6
 
 void callback( ){
     printf( "Deadline missed!\n\r" );
 }
 
+void defaultTask( void *pvParam );
+
+/* Task set: name, period, phase, deadline, WCET in us, predecessor, priority,
+ * task function and stack depth, see tmantaskset.h */
+#define DEMO_TASKS( X ) \
+    X( A, 1, 0, 0, 0, NONE, tskIDLE_PRIORITY + 3, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( B, 1, 0, 0, 0, NONE, tskIDLE_PRIORITY + 3, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( C, 3, 0, 0, 0, NONE, tskIDLE_PRIORITY + 2, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( D, 3, 1, 0, 0, NONE, tskIDLE_PRIORITY + 2, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( E, 9, 2, 0, 0, D,    tskIDLE_PRIORITY + 1, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( F, 9, 3, 0, 0, NONE, tskIDLE_PRIORITY + 1, defaultTask, configMINIMAL_STACK_SIZE )
+
+/* Task table and static storage of the tasks, no task uses the heap */
+TMAN_TASKSET_DEFINE( demoTaskSet, DEMO_TASKS, TMAN_TICK * 1000UL );
+
 void defaultTask( void *pvParam )
 {
     TickType_t tick;
@@ -46,7 +61,7 @@ void defaultTask( void *pvParam )
     
     for(;;) 
     {
-        err = TMAN_TaskWaitPeriod( (char *) pvParam );
+        err = TMAN_TaskWaitPeriodSelf();
         
         if( err )
             exit(err);
@@ -66,27 +81,8 @@ void defaultTask( void *pvParam )
 
 int mainTMAN( void )
 {
-    /* Iteration variable and error code */
-    uint32_t i, err;
-    /* Task names */
-    const char *arrNames[TMAN_NUMBER_TASK] = { "A", "B", "C", "D", "E", "F" };
-    /* Task period */
-    uint32_t arrPeriods[TMAN_NUMBER_TASK] = { 1, 1, 3, 3, 9, 9 };
-    /* Task phase */
-    uint32_t arrPhase[TMAN_NUMBER_TASK] = { 0, 0, 0, 1, 2, 3 };
-    /* Task deadline */
-    uint32_t arrDeadline[TMAN_NUMBER_TASK] = { 0, 0, 0, 0, 0, 0 };
-    /* Task precedence constrains */
-    const char *arrConstrains[TMAN_NUMBER_TASK] = { "", "", "", "", "D", "" };
-    /* Task priorities */
-    uint32_t arrPriorities[TMAN_NUMBER_TASK] = { tskIDLE_PRIORITY + 3,
-                                                    tskIDLE_PRIORITY + 3,
-                                                    tskIDLE_PRIORITY + 2,
-                                                    tskIDLE_PRIORITY + 2,
-                                                    tskIDLE_PRIORITY + 1,
-                                                    tskIDLE_PRIORITY + 1 };
-    /* Task handles */
-    TaskHandle_t arrHandles[TMAN_NUMBER_TASK] = { NULL, NULL, NULL, NULL, NULL, NULL };
+    /* Error code */
+    uint32_t err;
     
     // Set RA3 (LD4) and RC1 (LD5) as outputs
     TRISAbits.TRISA3 = 0;
@@ -119,51 +115,22 @@ int mainTMAN( void )
         exit(err);
     }
     
-    for( i = 0; i < TMAN_NUMBER_TASK; i++ )
-    {
-        /* Add tasks to framework */
-        err = TMAN_TaskAdd( arrNames[i] );
-        /* Exit program in case function returns an error code */
-        if( err )
-        {
-            printf("error: %d", err);
-            exit(err);
-        }
-    }
-    
-    for( i = 0; i < TMAN_NUMBER_TASK; i++ )
+    /* Add the task set and create its tasks */
+    err = TMAN_TASKSET_LOAD( demoTaskSet );
+    /* Exit program in case function returns an error code */
+    if( err )
     {
-        /* Register attributes for tasks */
-        err = TMAN_TaskRegisterAttributes( arrNames[i],
-                                                    arrPeriods[i],
-                                                    arrPhase[i],
-                                                    arrDeadline[i],
-                                                    arrConstrains[i] );
-        /* Exit program in case function returns an error code */
-        if( err )
-        {
-            printf("error: %d", err);
-            exit(err);
-        }
+        printf("error: %d", err);
+        exit(err);
     }
     
-    /* Create the tasks defined within this file. */
-    for( i = 0; i < TMAN_NUMBER_TASK; i++ )
+    /* Build the release table for the registered task set */
+    err = TMAN_Start();
+    /* Exit program in case function returns an error code */
+    if( err )
     {
-    //    /* Create tasks */
-        err = xTaskCreate(
-                defaultTask, 
-                arrNames[i], 
-                configMINIMAL_STACK_SIZE, 
-                ( void * ) arrNames[i], 
-                arrPriorities[i], 
-                &arrHandles[i] );
-        /* Exit program in case function returns an error code */
-        if( err != pdPASS )
-        {
-            printf("error: %d", err);
-            exit(err);
-        }
+        printf("error: %d", err);
+        exit(err);
     }
 
     /* Finally start the scheduler. */
@@ -24,20 +24,126 @@
 #include "../UART/uart.h"
 #include "tman.h"
 
+/* Aperiodic servers are scheduled like fixed priority tasks */
+#define tmanUSE_SERVERS     ( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_MAX_SERVERS > 0 )
+/* So are rate groups, a group task runs at the priority of its members */
+#define tmanUSE_GROUPS      ( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_MAX_GROUPS > 0 )
+
 /* Task structure */
 struct Task {
     const char *pcName;
     uint32_t taskPeriod;
     uint32_t taskPhase;
     uint32_t taskDeadline;
+    /* Worst case execution time in microseconds, 0 when not declared */
+    uint32_t taskWcet;
     const char * taskPrecedenceConstrains;
     uint32_t taskActivations;
     uint32_t lastActivationTick;
     uint32_t deadlineMisses;
+#if( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK )
+    /* Misses left to the reporter task by the default callback */
+    uint32_t missesPending;
+#endif
+    /* Job counters checked by the deadline events: jobs released so far,
+     * latest release served by the running job and last job completed */
+    uint32_t jobsReleased;
+    uint32_t jobServed;
+    uint32_t jobsCompleted;
+    /* Precedence edges, a job waits for the current job of every predecessor */
+    struct Task *pxPredecessors[TMAN_MAX_PREDECESSORS];
+    uint32_t predecessorCount;
+    /* Predecessors whose current job completed, one bit per pxPredecessors entry */
+    uint32_t predecessorsDone;
+    /* Tasks signalled when a job of this task completes */
+    struct Task *pxSuccessors[TMAN_MAX_SUCCESSORS];
+    uint32_t successorCount;
+    /* Sporadic task released by TMAN_TaskReleaseFromISR: minimum inter-arrival
+     * time in TMAN ticks and in timebase cycles, policy for early releases,
+     * earliest instant of the next release and whether one is deferred to it */
+    uint32_t minInterArrival;
+    uint64_t arrivalSpacing;
+    uint32_t sporadicPolicy;
+    uint64_t nextArrival;
+    uint32_t arrivalDeferred;
+    uint32_t releasesDropped;
+    uint32_t releasesDeferred;
+    /* Release of a job before the previous one completed: what to do with it,
+     * activations queued behind the running job and their bound, and the
+     * abort request of TMAN_OVERRUN_ABORT */
+    uint32_t overrunPolicy;
+    uint32_t backlog;
+    uint32_t maxBacklog;
+    uint32_t abortRequested;
+    uint32_t overruns;
+    uint32_t jobsSkipped;
+    uint32_t backlogMax;
+    /* Released by TMAN in the current mode, an inactive task waits in
+     * TMAN_TaskWaitPeriod until a mode activates it */
+    uint32_t active;
+    uint32_t waitingActivation;
+    /* Mixed criticality level and pessimistic budget in microseconds, taskWcet
+     * is the optimistic one, and releases skipped since the last one let
+     * through while a low criticality task is stretched */
+    uint32_t criticality;
+    uint32_t wcetHi;
+    uint32_t stretchCount;
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
     SemaphoreHandle_t xSemaphoreHandler;
+    /* Given when the current jobs of all predecessors completed */
     SemaphoreHandle_t xSemaphore;
-    uint32_t taskPrecedenceIndex;
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+    StaticSemaphore_t xSemaphoreHandlerBuffer;
+    StaticSemaphore_t xSemaphoreBuffer;
+#endif
+#else
+    /* Notifications sent before the FreeRTOS task was bound */
+    uint32_t pendingNotifications;
+#endif
     uint32_t execute;
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+    /* Rate or deadline monotonic priority, with manual priorities the one
+     * the FreeRTOS task had when it was bound */
+    UBaseType_t fixedPriority;
+#endif
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    /* Absolute deadline in TMAN ticks of the job in progress, valid while edfActive */
+    uint32_t edfDeadline;
+    uint32_t edfActive;
+    uint32_t lastReleaseTick;
+    /* Priority last given to the FreeRTOS task */
+    UBaseType_t edfPriority;
+#endif
+#if( TMAN_USE_JOB_STATS == 1 )
+    /* Timebase at the release of the current job and at its last switch in */
+    uint64_t releaseTime;
+    uint64_t switchInTime;
+    /* CPU time of the current job up to its last switch out */
+    uint32_t cpuTime;
+    /* Instant a sporadic job was allowed to be released, its release jitter reference */
+    uint64_t arrivalTime;
+    TMAN_JobStats_t jobStats;
+#endif
+#if( tmanUSE_SERVERS )
+    /* Server run by this task, its period, WCET and priority are the server's */
+    struct Server *pxServer;
+#endif
+#if( TMAN_MAX_RESOURCES > 0 )
+    /* Innermost resource locked by the running job, NULL when none */
+    struct Resource *pxHeld;
+#endif
+#if( tmanUSE_GROUPS )
+    /* Rate group whose task runs the jobs, and the job function it calls */
+    struct Group *pxGroup;
+    TMAN_Job_t pxJob;
+    void *pvJobArg;
+#endif
+#if( TMAN_NUM_CORES > 1 )
+    /* Core the partition placed the task on, TMAN_CORE_ANY until placed */
+    uint32_t core;
+#endif
+    /* FreeRTOS task bound to this record on its first wait */
+    TaskHandle_t xTaskHandle;
 };
 
 /* Global variables */
@@ -46,18 +152,250 @@ struct Task {
 const uint32_t g_freertosTickRateMs = portTICK_RATE_MS;
 /* Framework tick rate in freeRTOS ticks */
 uint32_t g_tmanTickInFreeRtosTicks;
+/* Framework tick rate in microseconds */
+uint32_t g_tmanTickRateUs;
 /* Current framework tick */
 uint32_t g_tmanCurrentTick;
-/* Number of tasks added in framework */
+/* Records of g_arrTask up to the last one in use, the loops over the tasks
+ * stop here, and records in use among them */
 uint32_t g_taskCounter;
-/* Array with all tasks created */
+static uint32_t g_tasksInUse;
+/* Pool of task records, TMAN_TaskRemove hands a record back for reuse */
 struct Task g_arrTask[TMAN_MAX_TASKS];
 /* Handle of the regulator task */
 TaskHandle_t xHandleRegulator;
 /* Handle of the deadline task */
 void (*g_ptrDeadlineCallback)();
-/* Show statistics */
+/* Show statistics from the reporter task */
 uint32_t showStats;
+/* Handle of the statistics reporter task */
+static TaskHandle_t xHandleReporter;
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+/* Storage of the tasks owned by TMAN */
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+static StackType_t g_regulatorStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t g_regulatorBuffer;
+#endif
+static StackType_t g_reporterStack[TMAN_REPORTER_STACK_SIZE];
+static StaticTask_t g_reporterBuffer;
+#endif
+/* Release structure in use, TMAN_RELEASE_SCAN until TMAN_Start succeeds, and
+ * whether the task set changed since so the regulator has to rebuild it */
+static uint32_t g_releaseMode;
+static uint32_t g_releaseRebuild;
+/* FreeRTOS tick at which TMAN tick 0 started */
+static TickType_t g_tmanStartTick;
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+/* Release table: tasks due in each slot of the hyperperiod, built by TMAN_Start */
+static uint16_t g_releaseSlotStart[TMAN_MAX_HYPERPERIOD + 1];
+static uint8_t g_releaseList[TMAN_MAX_RELEASES];
+static uint32_t g_hyperperiod;
+static uint32_t g_releaseSlot;
+#endif
+/* Event of a task at a TMAN tick, kept in min-heaps ordered by tick */
+struct TimedEvent {
+    uint32_t tick;
+    uint32_t index;
+    uint32_t job;
+};
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+/* Release queue: min-heap of the next release of every periodic task */
+static struct TimedEvent g_releaseHeap[TMAN_MAX_TASKS];
+static uint32_t g_releaseHeapSize;
+#endif
+/* Deadline queue: absolute deadline of every released job, events of
+ * completed jobs are dropped when they expire */
+static struct TimedEvent g_deadlineHeap[TMAN_MAX_DEADLINES];
+static uint32_t g_deadlineHeapSize;
+/* Deadline miss callback with lateness, NULL to use the TMAN_Init one */
+static void (*g_ptrDeadlineMissCallback)( const char *pcName, uint32_t lateness );
+/* Task set seen by the admission test, attributes in microseconds */
+struct AdmissionTask {
+    uint32_t period;
+    uint32_t deadline;
+    uint32_t wcet;
+    uint32_t key;
+    /* Release jitter, a deferrable server may run back to back across a release */
+    uint32_t jitter;
+    UBaseType_t priority;
+    /* Criticality and pessimistic budget, wcet for low criticality tasks */
+    uint32_t criticality;
+    uint32_t wcetHi;
+#if( TMAN_NUM_CORES > 1 )
+    /* Only tasks on the same core interfere, TMAN_CORE_ANY while not placed */
+    uint32_t core;
+#endif
+};
+static struct AdmissionTask g_admission[TMAN_MAX_TASKS];
+#if( TMAN_NUM_CORES > 1 )
+/* Admission task i placed on a core, and tasks i and j on the same one */
+#define tmanPLACED( i )             ( g_admission[i].core != TMAN_CORE_ANY )
+#define tmanSAME_CORE( i, j )       ( g_admission[j].core == g_admission[i].core )
+#else
+#define tmanPLACED( i )             ( 1 )
+#define tmanSAME_CORE( i, j )       ( 1 )
+#endif
+#if( tmanUSE_SERVERS )
+/* Aperiodic request waiting in a server, arrival is the low word of the timebase */
+struct ServerRequest {
+    TMAN_Request_t pxFunction;
+    void *pvArg;
+    uint32_t arrival;
+};
+/* Aperiodic server, budgets in timebase cycles */
+struct Server {
+    struct Task *pxTask;
+    uint32_t type;
+    uint32_t capacity;
+    /* Budget left, negative after a request overran it, the debt is paid
+     * from the next replenishment */
+    int32_t budget;
+    /* Last release of the task that refilled the budget */
+    uint32_t releasesSeen;
+    /* Sporadic server: start of the active interval, budget consumed in it
+     * and replenishments due, oldest first */
+    uint32_t active;
+    uint64_t activeSince;
+    uint32_t consumed;
+    uint64_t replenishTime[TMAN_MAX_REPLENISHMENTS];
+    uint32_t replenishAmount[TMAN_MAX_REPLENISHMENTS];
+    uint32_t replenishCount;
+    QueueHandle_t xQueue;
+    TMAN_ServerStats_t stats;
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+    StaticQueue_t xQueueBuffer;
+    uint8_t queueStorage[TMAN_SERVER_QUEUE_LENGTH * sizeof( struct ServerRequest )];
+    StackType_t stack[TMAN_SERVER_STACK_SIZE];
+    StaticTask_t taskBuffer;
+#endif
+};
+static struct Server g_servers[TMAN_MAX_SERVERS];
+static uint32_t g_serverCount;
+/* A deferrable or sporadic server paces itself on its budget and never
+ * waits for the end of its period, its jobs have no completion */
+#define tmanSELF_PACED( pxTask )    ( ( pxTask )->pxServer != NULL && ( pxTask )->pxServer->type != TMAN_SERVER_POLLING )
+#else
+#define tmanSELF_PACED( pxTask )    ( 0 )
+#endif
+#if( tmanUSE_GROUPS )
+/* Rate group, members in the order their jobs run */
+struct Group {
+    struct Task *pxMembers[TMAN_MAX_GROUP_MEMBERS];
+    uint32_t memberCount;
+    TaskHandle_t xTaskHandle;
+};
+static struct Group g_groups[TMAN_MAX_GROUPS];
+static uint32_t g_groupCount;
+#endif
+/* Sporadic tasks, the regulator then handles every TMAN tick, and releases
+ * deferred until the minimum inter-arrival time of their task elapses */
+static uint32_t g_sporadicTasks;
+static uint32_t g_deferredReleases;
+/* Criticality of the system, high criticality tasks whose budget the
+ * regulator watches on every TMAN tick, task that last raised the
+ * criticality and number of times it was raised */
+static uint32_t g_criticality;
+static uint32_t g_mcTasks;
+static struct Task *g_mcTrigger;
+static uint32_t g_criticalitySwitches;
+#if( TMAN_MAX_RESOURCES > 0 )
+/* Shared resource, its users are declared up front so its ceiling is known
+ * before any of them locks it */
+struct Resource {
+    const char *pcName;
+    struct Task *pxUsers[TMAN_MAX_RESOURCE_USERS];
+    uint32_t userCount;
+    /* Longest critical section of any user in microseconds */
+    uint32_t csUs;
+    /* Ceiling taken at the last lock: the highest base priority of the users,
+     * under EDF their shortest relative deadline in TMAN ticks */
+    uint32_t ceiling;
+    /* Job holding the resource and the resource it locked before this one */
+    struct Task *pxHolder;
+    struct Resource *pxNextHeld;
+};
+static struct Resource g_resources[TMAN_MAX_RESOURCES];
+static uint32_t g_resourceCount;
+#endif
+#if( TMAN_MAX_CHANNELS > 0 )
+#define tmanCHANNEL_NONE    ( 0xFF )
+/* Data channel on a precedence edge, slots given by the application */
+struct Channel {
+    struct Task *pxProducer;
+    struct Task *pxConsumer;
+    uint8_t *pucSlots;
+    uint32_t itemSize;
+    /* Slot filled by the producer job, slot published by its last completed
+     * job the consumer has not taken yet and slot read by the consumer job */
+    uint8_t write;
+    uint8_t ready;
+    uint8_t read;
+    /* The producer job asked for its slot, only then it is published */
+    uint8_t written;
+};
+static struct Channel g_channels[TMAN_MAX_CHANNELS];
+static uint32_t g_channelCount;
+#endif
+#if( TMAN_MAX_MODES > 0 )
+/* Attributes of a task in a mode saved by TMAN_ModeSave, phases relative to
+ * the tick the mode starts */
+struct ModeTask {
+    uint32_t active;
+    uint32_t period;
+    uint32_t phase;
+    uint32_t deadline;
+    const char *precedence;
+    struct Task *pxPredecessors[TMAN_MAX_PREDECESSORS];
+    uint32_t predecessorCount;
+};
+static struct ModeTask g_modes[TMAN_MAX_MODES][TMAN_MAX_TASKS];
+/* Tasks in each saved mode, tasks added later are inactive in it */
+static uint32_t g_modeTaskCount[TMAN_MAX_MODES];
+/* Current mode and the tick it started, pending mode change and its safe point */
+static uint32_t g_currentMode;
+static uint32_t g_modeStartTick;
+static uint32_t g_pendingMode;
+static uint32_t g_pendingWhen;
+static uint32_t g_modeBoundary;
+#endif
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+/* A release changed the set of active jobs since the last priority update */
+static uint32_t g_edfChanged;
+#endif
+/* 64 bit timebase: wraps of the 32 bit counter and its last value read */
+static uint32_t g_timebaseHigh;
+static uint32_t g_timebaseLast;
+#if( TMAN_USE_JOB_STATS == 1 )
+/* Timebase at the start of TMAN tick 0 and length of a TMAN tick in timebase cycles */
+static uint64_t g_timebaseEpoch;
+static uint32_t g_tickCycles;
+#endif
+#if( TMAN_USE_TRACE == 1 )
+/* Trace ring: records written and records drained so far, both free running */
+static TMAN_TraceRecord_t g_traceRing[TMAN_TRACE_LENGTH];
+static uint32_t g_traceHead;
+static uint32_t g_traceTail;
+#endif
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TICK_HOOK )
+/* FreeRTOS ticks elapsed in the current TMAN tick */
+static uint32_t g_tmanTickDivider;
+#endif
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+/* The regulator releases jobs with the scheduler suspended */
+#define tmanENTER_RELEASE()         vTaskSuspendAll()
+#define tmanEXIT_RELEASE()          ( void ) xTaskResumeAll()
+#else
+/* Jobs are released from an interrupt, keep it out while the structures change */
+#define tmanENTER_RELEASE()         taskENTER_CRITICAL()
+#define tmanEXIT_RELEASE()          taskEXIT_CRITICAL()
+#endif
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+/* Timer2 interrupt, the assembly wrapper in tman_isr.S saves the context */
+void __attribute__( (interrupt(IPL2AUTO), vector(_TIMER_2_VECTOR))) vTMANTimerInterruptWrapper( void );
+void TMAN_TimerInterruptHandler( void );
+#endif
 
 void TMAN_DeadlineCallback(const char * name)
 {    
@@ -67,284 +405,4385 @@ void TMAN_DeadlineCallback(const char * name)
     PrintStr(mesg);
 }
 
-void TMAN_TaskStats(const char * name)
+/* Wrap-safe "tick a is earlier than tick b" */
+#define prvTickBefore( a, b )       ( ( int32_t ) ( ( a ) - ( b ) ) < 0 )
+
+/* A record of the pool holds a task, free records have no name */
+#define prvTaskInUse( pxTask )      ( ( pxTask )->pcName != NULL )
+
+/* TMAN ticks between two releases of a task: its period, the minimum
+ * inter-arrival time of a sporadic task, 0 when only precedence releases it */
+#define prvReleaseSpacing( pxTask ) ( ( pxTask )->taskPeriod != 0 ? ( pxTask )->taskPeriod : ( pxTask )->minInterArrival )
+
+/* Find the record of a task by name, only used outside the job path */
+static struct Task * prvTaskFind( const char *pcName )
 {
     uint32_t i;
-    uint8_t mesg[80];
     
     for( i = 0; i < g_taskCounter; i++ ) 
     {
-        if (!strcmp(g_arrTask[i].pcName, name))
-        {
-            sprintf(mesg, "Task %s has %d activations\n\rTask %s has %d deadline misses\n\r",   \
-                    g_arrTask[i].pcName, g_arrTask[i].taskActivations, g_arrTask[i].pcName, g_arrTask[i].deadlineMisses );
-            PrintStr(mesg);
-            break;
-        }
+        if( prvTaskInUse( &g_arrTask[i] ) && !strcmp(g_arrTask[i].pcName, pcName) )
+            return &g_arrTask[i];
     }
+    
+    return NULL;
 }
 
-void TMAN_TickHandler( void *pvParam )
+/* Find a task named by the first len characters of pcName */
+static struct Task * prvTaskFindN( const char *pcName, size_t len )
 {
     uint32_t i;
-    TickType_t xLastWakeTime;
-    TickType_t tick;
     
-    /* Initialize the xLastWakeTime variable with the current time */
-    xLastWakeTime = xTaskGetTickCount();
+    for( i = 0; i < g_taskCounter; i++ ) 
+    {
+        if( prvTaskInUse( &g_arrTask[i] ) && !strncmp(g_arrTask[i].pcName, pcName, len) &&
+                g_arrTask[i].pcName[len] == '\0' )
+            return &g_arrTask[i];
+    }
     
-    for(;;)
+    return NULL;
+}
+
+/* Parse a comma separated list of task names, "" for none, into ppxTasks.
+ * Duplicates count once, an unknown name or more than max tasks fail */
+static int prvTaskListParse( const char *pcList, struct Task **ppxTasks, uint32_t max, uint32_t *pCount )
+{
+    const char *pcEnd;
+    struct Task *pxTask;
+    uint32_t i, count = 0;
+    
+    for( ; *pcList != '\0'; pcList = ( *pcEnd == ',' ) ? pcEnd + 1 : pcEnd )
     {
-        vTaskDelayUntil( &xLastWakeTime, (const TickType_t)g_tmanTickInFreeRtosTicks );
-        tick = xTaskGetTickCount(); 
+        pcEnd = strchr( pcList, ',' );
+        if( pcEnd == NULL )
+            pcEnd = pcList + strlen( pcList );
         
-        for( i = 0; i < g_taskCounter; i++ )
+        pxTask = prvTaskFindN( pcList, ( size_t ) ( pcEnd - pcList ) );
+        if( pxTask == NULL )
+            return TMAN_INVALID_PARAMETER;
+        
+        for( i = 0; i < count; i++ )
         {
-            /* Tick is equal to task phase so wake task */
-            if( g_tmanCurrentTick == g_arrTask[i].taskPhase )
-            {
-                if( g_arrTask[i].taskPeriod != 0 )
-                {
-                    xSemaphoreGive( g_arrTask[i].xSemaphoreHandler );
-                    if( g_arrTask[i].execute == 0 )
-                    {
-                        g_arrTask[i].lastActivationTick = g_tmanCurrentTick;
-                        g_arrTask[i].execute = 1;
-                    }
-                }
-            }
-            /* When phase tick has passed */
-            else if( g_tmanCurrentTick > g_arrTask[i].taskPhase )
-            {
-                if( g_arrTask[i].taskPeriod != 0 )
-                {
-                    /* Activate tasks periodically */
-                    if( ((g_tmanCurrentTick - g_arrTask[i].taskPhase) % g_arrTask[i].taskPeriod) == 0 )
-                    {
-                        xSemaphoreGive( g_arrTask[i].xSemaphoreHandler );
-                        if( g_arrTask[i].execute == 0 )
-                        {
-                            g_arrTask[i].lastActivationTick = g_tmanCurrentTick;
-                            g_arrTask[i].execute = 1;
-                        }
-                    }
-                }
-            }
+            if( ppxTasks[i] == pxTask )
+                break;
         }
+        if( i < count )
+            continue;
         
-        g_tmanCurrentTick++;
+        if( count >= max )
+            return TMAN_NO_MEM;
+        ppxTasks[count++] = pxTask;
     }
+    
+    *pCount = count;
+    return TMAN_SUCCESS;
 }
 
-int TMAN_Init( uint32_t tmanTickRateMs , uint32_t stats, void (*ptr)() )
+/* Bind a FreeRTOS task to a record so later lookups are O(1) */
+static void prvTaskBind( struct Task *pxTask, TaskHandle_t xHandle )
 {
-    uint32_t i;
+    vTaskSetThreadLocalStoragePointer( xHandle, TMAN_TLS_INDEX, ( void * ) pxTask );
     
-    /* Verify function parameters */
-    if( tmanTickRateMs <= 0 )
-        return TMAN_INVALID_PARAMETER;
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+    taskENTER_CRITICAL();
+    pxTask->xTaskHandle = xHandle;
     
-    if(!( stats == 0 || stats == 1))
-        return TMAN_INVALID_PARAMETER;
+    /* Replay what was signalled before the task existed */
+    if( pxTask->pendingNotifications & ( 1UL << TMAN_NOTIFY_INDEX_RELEASE ) )
+        xTaskNotifyGiveIndexed( pxTask->xTaskHandle, TMAN_NOTIFY_INDEX_RELEASE );
+    if( pxTask->pendingNotifications & ( 1UL << TMAN_NOTIFY_INDEX_PRECEDENCE ) )
+        xTaskNotifyGiveIndexed( pxTask->xTaskHandle, TMAN_NOTIFY_INDEX_PRECEDENCE );
+#if( tmanUSE_GROUPS )
+    /* A group task shares its notifications, the bits tell which member they are for */
+    if( pxTask->pxGroup == NULL )
+#endif
+        pxTask->pendingNotifications = 0;
+    taskEXIT_CRITICAL();
+#else
+    pxTask->xTaskHandle = xHandle;
+#endif
     
-    if( (tmanTickRateMs % g_freertosTickRateMs) != 0 )
-        return TMAN_TICK_RATE_NOT_MULTIPLE_FREERTOS_TICK;
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    vTaskPrioritySet( xHandle, pxTask->fixedPriority );
+#elif( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+    /* Base priority the resource ceilings are taken from */
+    pxTask->fixedPriority = uxTaskPriorityGet( xHandle );
+#endif
     
-    if (ptr != NULL)
-        g_ptrDeadlineCallback = ptr;
+#if( TMAN_NUM_CORES > 1 )
+    if( pxTask->core != TMAN_CORE_ANY )
+        vTaskCoreAffinitySet( xHandle, ( UBaseType_t ) 1 << pxTask->core );
+#endif
+}
+
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+/* Give one of the TMAN notifications of a task, pxWoken is non NULL in ISRs */
+static void prvNotify( struct Task *pxTask, UBaseType_t uxIndex, BaseType_t *pxWoken )
+{
+#if( tmanUSE_GROUPS )
+    UBaseType_t uxSavedMask;
+    
+    if( pxTask->pxGroup != NULL )
+    {
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        pxTask->pendingNotifications |= ( 1UL << uxIndex );
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+    }
+#endif
+    
+    if( pxTask->xTaskHandle == NULL )
+        pxTask->pendingNotifications |= ( 1UL << uxIndex );
+    else if( pxWoken != NULL )
+        vTaskNotifyGiveIndexedFromISR( pxTask->xTaskHandle, uxIndex, pxWoken );
     else
-        g_ptrDeadlineCallback = &TMAN_DeadlineCallback;
+        xTaskNotifyGiveIndexed( pxTask->xTaskHandle, uxIndex );
+}
+
+#if( tmanUSE_GROUPS )
+/* Take a notification of a rate group member: any notification wakes the
+ * group task, only the bit of the member ends the wait */
+static void prvGroupNotifyTake( struct Task *pxTask, UBaseType_t uxIndex, TickType_t xTicksToWait )
+{
+    UBaseType_t uxSavedMask;
+    uint32_t taken;
     
-    /* Initialize Handler */
-    xHandleRegulator = NULL;
+    for( ;; )
+    {
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        taken = pxTask->pendingNotifications & ( 1UL << uxIndex );
+        pxTask->pendingNotifications &= ~( 1UL << uxIndex );
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+        
+        if( taken || ulTaskNotifyTakeIndexed( uxIndex, pdTRUE, xTicksToWait ) == 0 )
+            return;
+    }
+}
+#endif
+#endif
+
+/* Signal the release of a new job, pxWoken is non NULL in ISRs */
+static void prvSignalRelease( struct Task *pxTask, BaseType_t *pxWoken )
+{
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+    prvNotify( pxTask, TMAN_NOTIFY_INDEX_RELEASE, pxWoken );
+#else
+    if( pxWoken != NULL )
+        xSemaphoreGiveFromISR( pxTask->xSemaphoreHandler, pxWoken );
+    else
+        xSemaphoreGive( pxTask->xSemaphoreHandler );
+#endif
+}
+
+/* Block the calling task until its next job is released */
+static void prvWaitRelease( struct Task *pxTask, TickType_t xTicksToWait )
+{
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+#if( tmanUSE_GROUPS )
+    if( pxTask->pxGroup != NULL )
+    {
+        prvGroupNotifyTake( pxTask, TMAN_NOTIFY_INDEX_RELEASE, xTicksToWait );
+        return;
+    }
+#endif
+    ( void ) pxTask;
+    ( void ) ulTaskNotifyTakeIndexed( TMAN_NOTIFY_INDEX_RELEASE, pdTRUE, xTicksToWait );
+#else
+    xSemaphoreTake( pxTask->xSemaphoreHandler, xTicksToWait );
+#endif
+}
+
+/* Read the 64 bit timebase from a task or an interrupt, it has to be read
+ * at least once per wrap of the counter, the releases take care of that */
+uint64_t TMAN_TimebaseGet( void )
+{
+    UBaseType_t uxSavedMask;
+    uint32_t count;
+    uint64_t now;
     
-    /* Creating the regulator task */    
-    xTaskCreate( TMAN_TickHandler, 
-                    "regulate",
-                    configMINIMAL_STACK_SIZE, 
-                    ( void * ) 1, 
-                    TMAN_PRIORITY_REGULATOR_TASK, 
-                    &xHandleRegulator );
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    count = TMAN_TIMEBASE_COUNT();
+    if( count < g_timebaseLast )
+        g_timebaseHigh++;
+    g_timebaseLast = count;
+    now = ( ( uint64_t ) g_timebaseHigh << 32 ) | count;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
     
-    g_tmanCurrentTick = 0;
-    g_taskCounter = 0;
-    g_tmanTickInFreeRtosTicks = tmanTickRateMs;
-    showStats = stats;
+    return now;
+}
+
+#if( TMAN_USE_TRACE == 1 )
+/* Append a trace record from a task or an interrupt, overwriting the oldest one */
+static void prvTrace( uint8_t event, const struct Task *pxTask, uint32_t arg )
+{
+    UBaseType_t uxSavedMask;
+    TMAN_TraceRecord_t *pxRecord;
     
-    return TMAN_SUCCESS;
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    pxRecord = &g_traceRing[g_traceHead & ( TMAN_TRACE_LENGTH - 1 )];
+    g_traceHead++;
+    pxRecord->timestamp = TMAN_TIMEBASE_COUNT();
+    pxRecord->event = event;
+    pxRecord->task = ( uint8_t ) ( pxTask - g_arrTask );
+    pxRecord->arg = ( uint16_t ) arg;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
 }
+    #define tmanTRACE( event, pxTask, arg )     prvTrace( ( event ), ( pxTask ), ( arg ) )
+/* Job numbers follow the releases, tasks released by precedence count their activations */
+    #define prvJobNumber( pxTask )  ( prvReleaseSpacing( pxTask ) != 0 ? ( pxTask )->jobServed : ( pxTask )->taskActivations )
+#else
+    #define tmanTRACE( event, pxTask, arg )
+#endif
 
-void TMAN_Close()
+#if( TMAN_USE_JOB_STATS == 1 )
+/* Account one job in a metric */
+static void prvMetricAdd( TMAN_Metric_t *pxMetric, uint32_t value )
 {
-    uint32_t i;
+    uint32_t bucket, scaled;
     
-    /* Delete regulator task */
-    vTaskDelete( xHandleRegulator );
+    if( pxMetric->count == 0 || value < pxMetric->min )
+        pxMetric->min = value;
+    if( value > pxMetric->max )
+        pxMetric->max = value;
+    pxMetric->sum += value;
+    pxMetric->count++;
     
-    /* Delete all created semaphores */
-    for( i = 0; i < g_taskCounter; i++ )
+    /* Bucket n > 0 holds [2^(n-1), 2^n) bucket widths */
+    scaled = value / ( TMAN_STATS_BUCKET_US * ( TMAN_TIMEBASE_HZ / 1000000UL ) );
+    bucket = ( scaled == 0 ) ? 0 : 32 - __builtin_clz( scaled );
+    if( bucket >= TMAN_STATS_BUCKETS )
+        bucket = TMAN_STATS_BUCKETS - 1;
+    pxMetric->histogram[bucket]++;
+}
+
+/* Stamp the release of a job and measure how far it is from the ideal instant
+ * of TMAN tick g_tmanCurrentTick, which ends one TMAN tick after it starts,
+ * or from the instant a sporadic job was allowed in */
+static void prvJobReleased( struct Task *pxTask )
+{
+    uint64_t now, nominal;
+    
+    now = TMAN_TimebaseGet();
+    if( pxTask->taskPeriod == 0 )
+        nominal = pxTask->arrivalTime;
+    else
+        nominal = g_timebaseEpoch + ( uint64_t ) ( g_tmanCurrentTick + 1 ) * g_tickCycles;
+    pxTask->releaseTime = now;
+    prvMetricAdd( &pxTask->jobStats.releaseJitter, ( now > nominal ) ? ( uint32_t ) ( now - nominal ) : 0 );
+}
+
+/* The job of the calling task passed its release and precedence waits */
+static void prvJobStarted( struct Task *pxTask )
+{
+    uint64_t now;
+    
+    taskENTER_CRITICAL();
+    now = TMAN_TimebaseGet();
+    pxTask->cpuTime = 0;
+    pxTask->switchInTime = now;
+    taskEXIT_CRITICAL();
+    
+    prvMetricAdd( &pxTask->jobStats.startLatency, ( uint32_t ) ( now - pxTask->releaseTime ) );
+}
+
+/* The job of the calling task completed */
+static void prvJobCompleted( struct Task *pxTask )
+{
+    uint64_t now;
+    uint32_t cpuTime;
+    
+    taskENTER_CRITICAL();
+    now = TMAN_TimebaseGet();
+    cpuTime = pxTask->cpuTime + ( uint32_t ) ( now - pxTask->switchInTime );
+    taskEXIT_CRITICAL();
+    
+    prvMetricAdd( &pxTask->jobStats.executionTime, cpuTime );
+    prvMetricAdd( &pxTask->jobStats.responseTime, ( uint32_t ) ( now - pxTask->releaseTime ) );
+}
+#endif
+
+/* Context switch hooks, see traceTASK_SWITCHED_IN/OUT in FreeRTOSConfig.h,
+ * they accumulate the CPU time of the jobs of bound tasks */
+void TMAN_TraceSwitchedIn( void )
+{
+#if( TMAN_USE_JOB_STATS == 1 || ( TMAN_USE_TRACE == 1 && TMAN_TRACE_SWITCHES == 1 ) )
+    struct Task *pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    
+    if( pxTask == NULL )
+        return;
+#if( TMAN_USE_JOB_STATS == 1 )
+    pxTask->switchInTime = TMAN_TimebaseGet();
+#endif
+#if( TMAN_USE_TRACE == 1 && TMAN_TRACE_SWITCHES == 1 )
+    prvTrace( TMAN_TRACE_SWITCH_IN, pxTask, 0 );
+#endif
+#endif
+}
+
+void TMAN_TraceSwitchedOut( void )
+{
+#if( TMAN_USE_JOB_STATS == 1 || ( TMAN_USE_TRACE == 1 && TMAN_TRACE_SWITCHES == 1 ) )
+    struct Task *pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    
+    if( pxTask == NULL )
+        return;
+#if( TMAN_USE_JOB_STATS == 1 )
+    pxTask->cpuTime += ( uint32_t ) ( TMAN_TimebaseGet() - pxTask->switchInTime );
+#endif
+#if( TMAN_USE_TRACE == 1 && TMAN_TRACE_SWITCHES == 1 )
+    prvTrace( TMAN_TRACE_SWITCH_OUT, pxTask, 0 );
+#endif
+#endif
+}
+
+/* Copy out the trace records not drained yet, oldest first */
+uint32_t TMAN_TraceRead( TMAN_TraceRecord_t *pxRecords, uint32_t maxRecords, uint32_t *pLost )
+{
+    uint32_t count = 0, lost = 0;
+#if( TMAN_USE_TRACE == 1 )
+    UBaseType_t uxSavedMask;
+    
+    /* One record per critical section keeps the interrupt latency flat */
+    while( count < maxRecords )
     {
-        vSemaphoreDelete( g_arrTask[i].xSemaphoreHandler );
-        vSemaphoreDelete( g_arrTask[i].xSemaphore );
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        if( g_traceHead - g_traceTail > TMAN_TRACE_LENGTH )
+        {
+            lost += g_traceHead - g_traceTail - TMAN_TRACE_LENGTH;
+            g_traceTail = g_traceHead - TMAN_TRACE_LENGTH;
+        }
+        if( g_traceTail == g_traceHead )
+        {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+            break;
+        }
+        pxRecords[count++] = g_traceRing[g_traceTail & ( TMAN_TRACE_LENGTH - 1 )];
+        g_traceTail++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
     }
+#endif
+    
+    if( pLost != NULL )
+        *pLost = lost;
+    
+    return count;
 }
 
-int TMAN_TaskAdd( const char *pcName )
+/* Drain the trace to the UART in the text form read by the host decoder,
+ * call it from a low priority task so the printing does not disturb the jobs */
+void TMAN_TraceDump( void )
 {
-    uint32_t i = 0;
+#if( TMAN_USE_TRACE == 1 )
+    TMAN_TraceRecord_t xRecords[8];
+    uint8_t mesg[40];
+    uint32_t i, count, lost;
     
-    /* Check if task name is already attributed in other task */
-    for( i = 0; i < g_taskCounter; i++ ) 
+    sprintf(mesg, "TMAN TRACE %lu %lu\n\r", ( unsigned long ) TMAN_TIMEBASE_HZ, ( unsigned long ) g_taskCounter );
+    PrintStr(mesg);
+    for( i = 0; i < g_taskCounter; i++ )
     {
-        if( !strcmp(g_arrTask[i].pcName, pcName) )
-            return TMAN_INVALID_TASK_NAME;
+        if( !prvTaskInUse( &g_arrTask[i] ) )
+            continue;
+        sprintf(mesg, "TASK %lu %.24s\n\r", ( unsigned long ) i, g_arrTask[i].pcName );
+        PrintStr(mesg);
     }
     
-    /* Add task to framework */
-    g_arrTask[g_taskCounter].pcName = pcName;
-    /* Initialize precedent semaphore */
-    g_arrTask[g_taskCounter].xSemaphore = xSemaphoreCreateBinary();
-    /* Initialize handler semaphore */
-    g_arrTask[g_taskCounter].xSemaphoreHandler = xSemaphoreCreateBinary();
+    do
+    {
+        count = TMAN_TraceRead( xRecords, 8, &lost );
+        if( lost != 0 )
+        {
+            sprintf(mesg, "LOST %lu\n\r", ( unsigned long ) lost);
+            PrintStr(mesg);
+        }
+        for( i = 0; i < count; i++ )
+        {
+            sprintf(mesg, "%08lx %02x %02x %04x\n\r", ( unsigned long ) xRecords[i].timestamp,
+                    xRecords[i].event, xRecords[i].task, xRecords[i].arg );
+            PrintStr(mesg);
+        }
+    } while( count == 8 );
     
-    if( g_arrTask[g_taskCounter].xSemaphore == NULL || \
-            g_arrTask[g_taskCounter].xSemaphoreHandler == NULL )
-        return TMAN_NO_MEM;
+    PrintStr("TMAN TRACE END\n\r");
+#endif
+}
+
+/* Current TMAN tick as seen by the tasks */
+static uint32_t prvTmanGetTick( void )
+{
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+    /* The sleeping regulator does not count ticks, derive them from the kernel */
+    if( g_releaseMode == TMAN_RELEASE_QUEUE )
+        return ( uint32_t ) ( xTaskGetTickCount() - g_tmanStartTick ) / g_tmanTickInFreeRtosTicks;
+#endif
+    
+    return g_tmanCurrentTick;
+}
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+/* Deadline of a job relative to its release, also the preemption level of the
+ * task under the Stack Resource Policy, the shorter the higher */
+#define prvRelativeDeadline( pxTask )   ( ( ( pxTask )->taskDeadline > 0 ) ? ( pxTask )->taskDeadline : prvReleaseSpacing( pxTask ) )
+
+#if( TMAN_MAX_RESOURCES > 0 )
+/* A job that holds no resource and whose preemption level does not exceed
+ * the system ceiling may not start */
+#define prvEdfHeldBack( pxTask, ceiling )   ( ( pxTask )->pxHeld == NULL && prvRelativeDeadline( pxTask ) >= ( ceiling ) )
+#else
+#define prvEdfHeldBack( pxTask, ceiling )   ( 0 )
+#endif
+
+/* Start tracking the job released at releaseTick, an overrun job keeps its deadline */
+static void prvEdfActivate( struct Task *pxTask, uint32_t releaseTick )
+{
+    pxTask->lastReleaseTick = releaseTick;
     
-    /* Increment task counter */
-    g_taskCounter++;
+    if( !pxTask->edfActive )
+    {
+        /* Implicit deadline when none was registered */
+        pxTask->edfDeadline = releaseTick + prvRelativeDeadline( pxTask );
+        pxTask->edfActive = 1;
+    }
     
-    return TMAN_SUCCESS;
+    g_edfChanged = 1;
 }
 
-int TMAN_TaskRegisterAttributes(const char *pcName, uint32_t taskPeriod, uint32_t taskPhase,
-        uint32_t taskDeadline, const char *taskPrecedenceConstrains )
+/* The current job completed, the oldest queued activation becomes the next job */
+static void prvEdfComplete( struct Task *pxTask )
 {
-    uint32_t i, validTask = 1, taskIndex, taskPrecedenceIndex = 0, validPrecedence = 1;
+    if( pxTask->jobsReleased == pxTask->jobServed + 1 )
+        pxTask->edfDeadline = pxTask->lastReleaseTick + prvRelativeDeadline( pxTask );
+    else if( pxTask->jobsReleased != pxTask->jobServed )
+        pxTask->edfDeadline += prvReleaseSpacing( pxTask );
+    else
+        pxTask->edfActive = 0;
     
-    if( !strcmp(pcName, taskPrecedenceConstrains) )
-        return TMAN_INVALID_PARAMETER;
+    g_edfChanged = 1;
+}
+
+/* Rank the active jobs by absolute deadline, ties by task index, and give
+ * the earliest ones the highest priorities of the EDF band. Jobs held back
+ * by the ceiling of a locked resource rank after all the others. Called
+ * with the scheduler suspended */
+static void prvEdfReschedule( void )
+{
+    uint32_t i, k, rank, heldBack, systemCeiling = UINT32_MAX;
+    struct Task *pxTask;
+    UBaseType_t uxPriority;
     
-    /* Check if task is already added in framework */
-    for( i = 0; i < g_taskCounter; i++ ) 
+#if( TMAN_MAX_RESOURCES > 0 )
+    /* System ceiling, the highest preemption level of the locked resources */
+    for( k = 0; k < g_resourceCount; k++ )
     {
-        if( !strcmp(g_arrTask[i].pcName, pcName) )
-        { 
-            validTask = 0;
-            taskIndex = i;
-        }
-        /* Save task precedence index */
-        if( !strcmp(g_arrTask[i].pcName, taskPrecedenceConstrains) )
-            taskPrecedenceIndex = i;
+        if( g_resources[k].pxHolder != NULL && g_resources[k].ceiling < systemCeiling )
+            systemCeiling = g_resources[k].ceiling;
     }
+#endif
     
-    /* check if valid precedence task is given */
-    for( i = 0; i < g_taskCounter; i++ ) 
+    for( i = 0; i < g_taskCounter; i++ )
     {
-        if( strcmp("", taskPrecedenceConstrains) )
+        pxTask = &g_arrTask[i];
+        uxPriority = TMAN_TASK_PRIORITY_LOW;
+        
+        if( pxTask->edfActive )
         {
-            if( !strcmp(g_arrTask[i].pcName, taskPrecedenceConstrains) )
+            rank = 0;
+            heldBack = prvEdfHeldBack( pxTask, systemCeiling );
+            for( k = 0; k < g_taskCounter; k++ )
             {
-                validPrecedence = 0;
-                break;
+                if( k == i || !g_arrTask[k].edfActive )
+                    continue;
+                if( prvEdfHeldBack( &g_arrTask[k], systemCeiling ) != heldBack )
+                {
+                    if( heldBack )
+                        rank++;
+                    continue;
+                }
+                if( prvTickBefore( g_arrTask[k].edfDeadline, pxTask->edfDeadline ) ||
+                        ( g_arrTask[k].edfDeadline == pxTask->edfDeadline && k < i ) )
+                    rank++;
             }
+            
+            /* Jobs past the band share its lowest priority */
+            if( rank < TMAN_TASK_PRIORITY_HIGH - TMAN_TASK_PRIORITY_LOW )
+                uxPriority = TMAN_TASK_PRIORITY_HIGH - rank;
         }
-        else
+        
+        if( pxTask->xTaskHandle != NULL && pxTask->edfPriority != uxPriority )
         {
-            validPrecedence = 0;
-            break;
+            vTaskPrioritySet( pxTask->xTaskHandle, uxPriority );
+            pxTask->edfPriority = uxPriority;
         }
     }
     
-    /* If the task was not added return error code */
-    if( validTask )
-        return TMAN_INVALID_TASK_NAME;
-    
-    if( validPrecedence )
-        return TMAN_INVALID_PARAMETER;
-    
-    /* Check valid parameters */
-    if( taskPeriod < 0 || taskPhase < 0 || taskDeadline < 0 )
-        return TMAN_INVALID_PARAMETER;
+    g_edfChanged = 0;
+}
+#endif
+
+/* Signal that a job completed to the tasks that depend on it */
+static void prvSignalCompletion( struct Task *pxTask )
+{
+    uint32_t i, k, joined;
+    struct Task *pxSuccessor;
     
-    /* Define task structure variables */
-    g_arrTask[taskIndex].taskPeriod = taskPeriod;
-    g_arrTask[taskIndex].taskPhase = taskPhase;
-    g_arrTask[taskIndex].taskDeadline = taskDeadline;
-    g_arrTask[taskIndex].taskPrecedenceConstrains = taskPrecedenceConstrains;
-    g_arrTask[taskIndex].taskPrecedenceIndex = taskPrecedenceIndex;
+    for( i = 0; i < pxTask->successorCount; i++ )
+    {
+        pxSuccessor = pxTask->pxSuccessors[i];
+        
+        /* Inactive tasks take no part in joins until a mode activates them */
+        if( !pxSuccessor->active )
+            continue;
+        
+        for( k = 0; k < pxSuccessor->predecessorCount; k++ )
+        {
+            if( pxSuccessor->pxPredecessors[k] == pxTask )
+                break;
+        }
+        
+        /* A join is signalled once the last of its predecessors completes,
+         * repeated completions of one predecessor only count once */
+        taskENTER_CRITICAL();
+        pxSuccessor->predecessorsDone |= ( 1UL << k );
+        joined = ( pxSuccessor->predecessorsDone == ( 1UL << pxSuccessor->predecessorCount ) - 1 );
+        if( joined )
+            pxSuccessor->predecessorsDone = 0;
+        taskEXIT_CRITICAL();
+        
+        if( joined )
+        {
+            /* Tasks without releases of their own are released by their last predecessor */
+            if( prvReleaseSpacing( pxSuccessor ) == 0 )
+            {
+#if( TMAN_USE_JOB_STATS == 1 )
+                pxSuccessor->releaseTime = TMAN_TimebaseGet();
+#endif
+                tmanTRACE( TMAN_TRACE_RELEASE, pxSuccessor, pxSuccessor->taskActivations + 1 );
+            }
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+            if( prvReleaseSpacing( pxSuccessor ) == 0 && pxSuccessor->taskDeadline > 0 )
+                prvEdfActivate( pxSuccessor, prvTmanGetTick() - 1 );
+#endif
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+            prvNotify( pxSuccessor, TMAN_NOTIFY_INDEX_PRECEDENCE, NULL );
+#else
+            xSemaphoreGive( pxSuccessor->xSemaphore );
+#endif
+        }
+    }
+}
+
+#if( TMAN_MAX_CHANNELS > 0 )
+/* Publish the slots filled by the job that completed, a slot its consumer did
+ * not take yet is reused. The next slot is the one neither published nor read */
+static void prvChannelPublish( struct Task *pxTask )
+{
+    struct Channel *pxChannel;
+    uint32_t c;
+    uint8_t slot;
     
-    return TMAN_SUCCESS;
+    for( c = 0; c < g_channelCount; c++ )
+    {
+        pxChannel = &g_channels[c];
+        if( pxChannel->pxProducer != pxTask || !pxChannel->written )
+            continue;
+        
+        taskENTER_CRITICAL();
+        pxChannel->ready = pxChannel->write;
+        for( slot = 0; slot == pxChannel->ready || slot == pxChannel->read; slot++ )
+            ;
+        pxChannel->write = slot;
+        pxChannel->written = 0;
+        taskEXIT_CRITICAL();
+    }
 }
 
-int TMAN_TaskWaitPeriod( char *pcName )
+/* Give the job that starts the latest published slot of its channels, a job
+ * released with nothing new published reads the slot of the previous one */
+static void prvChannelTake( struct Task *pxTask )
 {
-    uint32_t i, validTask = 1, taskIndex;
+    struct Channel *pxChannel;
+    uint32_t c;
     
-    /* Check if task is already added in framework */
-    for( i = 0; i < g_taskCounter; i++ ) 
+    for( c = 0; c < g_channelCount; c++ )
     {
-        if( !strcmp(g_arrTask[i].pcName, pcName) )
-        { 
-            validTask = 0;
-            taskIndex = i;
-            break;
-        }
+        pxChannel = &g_channels[c];
+        if( pxChannel->pxConsumer != pxTask || pxChannel->ready == tmanCHANNEL_NONE )
+            continue;
+        
+        taskENTER_CRITICAL();
+        pxChannel->read = pxChannel->ready;
+        pxChannel->ready = tmanCHANNEL_NONE;
+        taskEXIT_CRITICAL();
+    }
+}
+#endif
+
+/* Block the calling task until all its predecessors completed a job */
+static void prvWaitPrecedence( struct Task *pxTask )
+{
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 )
+#if( tmanUSE_GROUPS )
+    if( pxTask->pxGroup != NULL )
+    {
+        prvGroupNotifyTake( pxTask, TMAN_NOTIFY_INDEX_PRECEDENCE, portMAX_DELAY );
+        return;
     }
+#endif
+    ( void ) pxTask;
+    ( void ) ulTaskNotifyTakeIndexed( TMAN_NOTIFY_INDEX_PRECEDENCE, pdTRUE, portMAX_DELAY );
+#else
+    xSemaphoreTake( pxTask->xSemaphore, portMAX_DELAY );
+#endif
+}
+
+/* Whether pxTo can be reached from pxFrom following precedence edges */
+static uint32_t prvPrecedenceReaches( struct Task *pxFrom, struct Task *pxTo )
+{
+    struct Task *pxStack[TMAN_MAX_TASKS];
+    uint8_t visited[TMAN_MAX_TASKS];
+    uint32_t i, depth = 0;
+    struct Task *pxTask;
     
-    if( validTask )
-        return TMAN_INVALID_TASK_NAME;
+    memset( visited, 0, sizeof( visited ) );
+    pxStack[depth++] = pxFrom;
+    visited[pxFrom - g_arrTask] = 1;
     
-    /* Detect deadline misses */
-    if( g_arrTask[taskIndex].taskActivations != 0 && g_arrTask[taskIndex].taskDeadline > 0)
+    while( depth > 0 )
     {
-        if( (g_arrTask[taskIndex].lastActivationTick + g_arrTask[taskIndex].taskDeadline) < (g_tmanCurrentTick - 1) )
+        pxTask = pxStack[--depth];
+        if( pxTask == pxTo )
+            return 1;
+        
+        for( i = 0; i < pxTask->successorCount; i++ )
         {
-            g_arrTask[taskIndex].deadlineMisses++;
-            if(g_ptrDeadlineCallback == &TMAN_DeadlineCallback){
-                (*g_ptrDeadlineCallback) ( g_arrTask[taskIndex].pcName );
-            }
-            else{
-                (*g_ptrDeadlineCallback)();
+            if( !visited[pxTask->pxSuccessors[i] - g_arrTask] )
+            {
+                visited[pxTask->pxSuccessors[i] - g_arrTask] = 1;
+                pxStack[depth++] = pxTask->pxSuccessors[i];
             }
         }
     }
     
-    /* Show statistics if flag is 1 */
-    if( showStats )
-        TMAN_TaskStats( g_arrTask[taskIndex].pcName );
-    
-    /* Don't do a give if it is the first tick */
-    if( g_tmanCurrentTick != 0 )
-        xSemaphoreGive( g_arrTask[taskIndex].xSemaphore );
+    return 0;
+}
+
+/* Add the edge pxPredecessor -> pxTask, refusing edges that close a cycle */
+static int prvPrecedenceLink( struct Task *pxTask, struct Task *pxPredecessor )
+{
+    uint32_t i;
     
-    /* Task is suspended until regulator task awakes it */
-    if( g_arrTask[taskIndex].taskPeriod != 0 )
+    for( i = 0; i < pxTask->predecessorCount; i++ )
     {
-        xSemaphoreTake( g_arrTask[taskIndex].xSemaphoreHandler,
-            portMAX_DELAY );
+        if( pxTask->pxPredecessors[i] == pxPredecessor )
+            return TMAN_SUCCESS;
     }
     
-    /* If this task has a precedence task it blocks on his semaphore */
-    if( strcmp(g_arrTask[taskIndex].taskPrecedenceConstrains,"") )
+    if( pxTask->predecessorCount >= TMAN_MAX_PREDECESSORS ||
+            pxPredecessor->successorCount >= TMAN_MAX_SUCCESSORS )
+        return TMAN_NO_MEM;
+    
+    if( prvPrecedenceReaches( pxTask, pxPredecessor ) )
+        return TMAN_PRECEDENCE_CYCLE;
+    
+    pxTask->pxPredecessors[pxTask->predecessorCount++] = pxPredecessor;
+    pxPredecessor->pxSuccessors[pxPredecessor->successorCount++] = pxTask;
+    pxTask->predecessorsDone = 0;
+    
+    return TMAN_SUCCESS;
+}
+
+/* Remove every edge towards a task */
+static void prvPrecedenceClear( struct Task *pxTask )
+{
+    uint32_t i, k;
+    struct Task *pxOld;
+    
+    for( i = 0; i < pxTask->predecessorCount; i++ )
     {
-        if( g_arrTask[i].execute == 0 && g_arrTask[i].taskPeriod != 0)
-        {
-            g_arrTask[i].lastActivationTick = g_tmanCurrentTick-1;
-            g_arrTask[i].execute = 1;
-        }
-        xSemaphoreTake( g_arrTask[g_arrTask[taskIndex].taskPrecedenceIndex].xSemaphore,
-                 portMAX_DELAY );
-        if( g_arrTask[i].execute == 0 && g_arrTask[i].taskPeriod == 0)
+        pxOld = pxTask->pxPredecessors[i];
+        
+        for( k = 0; k < pxOld->successorCount; k++ )
         {
-            g_arrTask[i].lastActivationTick = g_tmanCurrentTick-1;
-            g_arrTask[i].execute = 1;
+            if( pxOld->pxSuccessors[k] == pxTask )
+            {
+                pxOld->pxSuccessors[k] = pxOld->pxSuccessors[--pxOld->successorCount];
+                break;
+            }
         }
     }
     
-    g_arrTask[taskIndex].taskActivations++;
-    g_arrTask[taskIndex].execute = 0;
+    pxTask->predecessorCount = 0;
+    pxTask->predecessorsDone = 0;
+}
+
+/* Whether edges from count predecessors can replace every edge towards a
+ * task, checked before any edge is removed */
+static int prvPrecedenceCheck( struct Task *pxTask, struct Task * const *ppxPredecessors, uint32_t count )
+{
+    uint32_t i, k;
+    
+    if( count > TMAN_MAX_PREDECESSORS )
+        return TMAN_NO_MEM;
+    
+    for( i = 0; i < count; i++ )
+    {
+        /* An edge the task already has keeps its successor slot */
+        for( k = 0; k < pxTask->predecessorCount && pxTask->pxPredecessors[k] != ppxPredecessors[i]; k++ );
+        if( k == pxTask->predecessorCount && ppxPredecessors[i]->successorCount >= TMAN_MAX_SUCCESSORS )
+            return TMAN_NO_MEM;
+        
+        /* Edges towards the task are not followed from it, they do not
+         * change the answer */
+        if( prvPrecedenceReaches( pxTask, ppxPredecessors[i] ) )
+            return TMAN_PRECEDENCE_CYCLE;
+    }
+    
+    return TMAN_SUCCESS;
+}
+
+void TMAN_TaskStatsByHandle( TMAN_TaskHandle_t xTask )
+{
+    uint8_t mesg[80];
+    
+    if( xTask == NULL )
+        return;
+    
+    sprintf(mesg, "Task %s has %d activations\n\rTask %s has %d deadline misses\n\r",   \
+            xTask->pcName, xTask->taskActivations, xTask->pcName, xTask->deadlineMisses );
+    PrintStr(mesg);
+    
+#if( TMAN_NUM_CORES > 1 )
+    if( xTask->core != TMAN_CORE_ANY )
+    {
+        sprintf(mesg, "Task %s runs on core %u\n\r", xTask->pcName, ( unsigned ) xTask->core );
+        PrintStr(mesg);
+    }
+#endif
+    
+#if( TMAN_USE_JOB_STATS == 1 )
+    if( xTask->jobStats.responseTime.count != 0 )
+    {
+        sprintf(mesg, "Task %s response min/avg/max %u/%u/%u us\n\r", xTask->pcName,
+                ( unsigned ) TMAN_TIMEBASE_TO_US( xTask->jobStats.responseTime.min ),
+                ( unsigned ) TMAN_TIMEBASE_TO_US( xTask->jobStats.responseTime.sum / xTask->jobStats.responseTime.count ),
+                ( unsigned ) TMAN_TIMEBASE_TO_US( xTask->jobStats.responseTime.max ) );
+        PrintStr(mesg);
+    }
+#endif
+}
+
+/* Copy the counters of a task, the caller keeps them consistent */
+static void prvTaskSnapshot( const struct Task *pxTask, TMAN_TaskStats_t *pxStats )
+{
+    pxStats->pcName = pxTask->pcName;
+#if( TMAN_NUM_CORES > 1 )
+    pxStats->core = pxTask->core;
+#else
+    pxStats->core = 0;
+#endif
+    pxStats->activations = pxTask->taskActivations;
+    pxStats->jobsReleased = pxTask->jobsReleased;
+    pxStats->jobsCompleted = pxTask->jobsCompleted;
+    pxStats->deadlineMisses = pxTask->deadlineMisses;
+    pxStats->releasesDropped = pxTask->releasesDropped;
+    pxStats->releasesDeferred = pxTask->releasesDeferred;
+    pxStats->overruns = pxTask->overruns;
+    pxStats->jobsSkipped = pxTask->jobsSkipped;
+    pxStats->backlogMax = pxTask->backlogMax;
+#if( TMAN_USE_JOB_STATS == 1 )
+    pxStats->responseMin = pxTask->jobStats.responseTime.min;
+    pxStats->responseMax = pxTask->jobStats.responseTime.max;
+    pxStats->responseSum = pxTask->jobStats.responseTime.sum;
+    pxStats->responseCount = pxTask->jobStats.responseTime.count;
+#else
+    pxStats->responseMin = 0;
+    pxStats->responseMax = 0;
+    pxStats->responseSum = 0;
+    pxStats->responseCount = 0;
+#endif
+}
+
+/* Snapshot of every task taken in one critical section, so no release,
+ * completion or miss lands between two tasks of the snapshot */
+int TMAN_GetStats( TMAN_Stats_t *pxStats )
+{
+    uint32_t i;
+    
+    if( pxStats == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    taskENTER_CRITICAL();
+    pxStats->tick = prvTmanGetTick();
+    pxStats->criticality = g_criticality;
+    pxStats->criticalitySwitches = g_criticalitySwitches;
+    pxStats->taskCount = 0;
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( prvTaskInUse( &g_arrTask[i] ) )
+            prvTaskSnapshot( &g_arrTask[i], &pxStats->tasks[pxStats->taskCount++] );
+    }
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskGetStats( TMAN_TaskHandle_t xTask, TMAN_TaskStats_t *pxStats )
+{
+    if( xTask == NULL || pxStats == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    taskENTER_CRITICAL();
+    prvTaskSnapshot( xTask, pxStats );
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+}
+
+/* Print a snapshot, runs in the reporter task and never on the job path */
+static void prvStatsReport( const TMAN_Stats_t *pxStats )
+{
+    uint8_t mesg[96];
+    uint32_t i;
+    const TMAN_TaskStats_t *pxTask;
+    
+    sprintf(mesg, "TMAN stats at tick %lu", ( unsigned long ) pxStats->tick);
+    PrintStr(mesg);
+    if( pxStats->criticalitySwitches != 0 )
+    {
+        sprintf(mesg, ", criticality %s, raised %lu times", ( pxStats->criticality == TMAN_CRIT_HI ) ? "high" : "low",
+                ( unsigned long ) pxStats->criticalitySwitches);
+        PrintStr(mesg);
+    }
+    PrintStr("\n\r");
+    
+    for( i = 0; i < pxStats->taskCount; i++ )
+    {
+        pxTask = &pxStats->tasks[i];
+        sprintf(mesg, "Task %s: %lu jobs, %lu deadline misses", pxTask->pcName,
+                ( unsigned long ) pxTask->activations, ( unsigned long ) pxTask->deadlineMisses);
+        PrintStr(mesg);
+        
+        if( pxTask->responseCount != 0 )
+        {
+            sprintf(mesg, ", response min/avg/max %lu/%lu/%lu us",
+                    ( unsigned long ) TMAN_TIMEBASE_TO_US( pxTask->responseMin ),
+                    ( unsigned long ) TMAN_TIMEBASE_TO_US( pxTask->responseSum / pxTask->responseCount ),
+                    ( unsigned long ) TMAN_TIMEBASE_TO_US( pxTask->responseMax ));
+            PrintStr(mesg);
+        }
+        
+        if( pxTask->overruns != 0 || pxTask->jobsSkipped != 0 )
+        {
+            sprintf(mesg, ", %lu overruns %lu skipped backlog max %lu", ( unsigned long ) pxTask->overruns,
+                    ( unsigned long ) pxTask->jobsSkipped, ( unsigned long ) pxTask->backlogMax);
+            PrintStr(mesg);
+        }
+        
+        if( pxTask->releasesDropped != 0 || pxTask->releasesDeferred != 0 )
+        {
+            sprintf(mesg, ", early releases %lu dropped %lu deferred",
+                    ( unsigned long ) pxTask->releasesDropped, ( unsigned long ) pxTask->releasesDeferred);
+            PrintStr(mesg);
+        }
+        PrintStr("\n\r");
+    }
+}
+
+#if( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK )
+/* Print the misses the default callback left since the last call, it does
+ * not write the UART from the tick or Timer2 interrupt */
+static void prvMissesReport( void )
+{
+    const char *pcName;
+    uint32_t i, misses;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        /* The record may be freed or reused meanwhile */
+        taskENTER_CRITICAL();
+        pcName = g_arrTask[i].pcName;
+        misses = g_arrTask[i].missesPending;
+        g_arrTask[i].missesPending = 0;
+        taskEXIT_CRITICAL();
+        
+        while( pcName != NULL && misses-- > 0 )
+            TMAN_DeadlineCallback( pcName );
+    }
+}
+#endif
+
+/* Prints the statistics of all tasks every TMAN_REPORT_PERIOD TMAN ticks,
+ * below every TMAN task so formatting and the UART never delay a job. With
+ * an interrupt time source it also prints the default deadline miss reports */
+static void prvReporterTask( void *pvParam )
+{
+    /* Too big for the stack of the task */
+    static TMAN_Stats_t xSnapshot;
+    TickType_t xLastWakeTime, xPeriod;
+    
+    xPeriod = ( TMAN_REPORT_PERIOD * g_tmanTickRateUs ) / ( g_freertosTickRateMs * 1000UL );
+    if( xPeriod == 0 )
+        xPeriod = 1;
+    
+    xLastWakeTime = xTaskGetTickCount();
+    for(;;)
+    {
+        vTaskDelayUntil( &xLastWakeTime, xPeriod );
+#if( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK )
+        prvMissesReport();
+#endif
+        if( showStats )
+        {
+            TMAN_GetStats( &xSnapshot );
+            prvStatsReport( &xSnapshot );
+        }
+    }
+}
+
+/* Copy the job statistics of a task, consistent with the jobs in progress */
+int TMAN_TaskGetJobStats( TMAN_TaskHandle_t xTask, TMAN_JobStats_t *pxStats )
+{
+    if( xTask == NULL || pxStats == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_USE_JOB_STATS == 1 )
+    taskENTER_CRITICAL();
+    *pxStats = xTask->jobStats;
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Restart the job statistics of a task, for example after a warm up phase */
+int TMAN_TaskResetJobStats( TMAN_TaskHandle_t xTask )
+{
+    if( xTask == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_USE_JOB_STATS == 1 )
+    taskENTER_CRITICAL();
+    memset( &xTask->jobStats, 0, sizeof( TMAN_JobStats_t ) );
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+void TMAN_TaskStats(const char * name)
+{
+    TMAN_TaskStatsByHandle( prvTaskFind( name ) );
+}
+
+void TMAN_SetDeadlineMissCallback( void (*ptr)( const char *pcName, uint32_t lateness ) )
+{
+    g_ptrDeadlineMissCallback = ptr;
+}
+
+/* Heap order: earliest event first, ties by task index like the scan */
+static uint32_t prvEventEarlier( const struct TimedEvent *pxA, const struct TimedEvent *pxB )
+{
+    if( pxA->tick != pxB->tick )
+        return prvTickBefore( pxA->tick, pxB->tick );
+    
+    return pxA->index < pxB->index;
+}
+
+/* Restore the heap property from position pos downwards */
+static void prvEventSiftDown( struct TimedEvent *pxHeap, uint32_t size, uint32_t pos )
+{
+    uint32_t child;
+    struct TimedEvent xEvent = pxHeap[pos];
+    
+    for( ;; )
+    {
+        child = 2 * pos + 1;
+        if( child >= size )
+            break;
+        if( child + 1 < size && prvEventEarlier( &pxHeap[child + 1], &pxHeap[child] ) )
+            child++;
+        if( !prvEventEarlier( &pxHeap[child], &xEvent ) )
+            break;
+        pxHeap[pos] = pxHeap[child];
+        pos = child;
+    }
+    
+    pxHeap[pos] = xEvent;
+}
+
+static void prvEventInsert( struct TimedEvent *pxHeap, uint32_t *pSize, uint32_t tick,
+        uint32_t index, uint32_t job )
+{
+    uint32_t pos, parent;
+    struct TimedEvent xEvent;
+    
+    xEvent.tick = tick;
+    xEvent.index = index;
+    xEvent.job = job;
+    
+    for( pos = ( *pSize )++; pos > 0; pos = parent )
+    {
+        parent = ( pos - 1 ) / 2;
+        if( !prvEventEarlier( &xEvent, &pxHeap[parent] ) )
+            break;
+        pxHeap[pos] = pxHeap[parent];
+    }
+    
+    pxHeap[pos] = xEvent;
+}
+
+/* Remove the earliest event */
+static void prvEventPop( struct TimedEvent *pxHeap, uint32_t *pSize )
+{
+    if( --( *pSize ) > 0 )
+    {
+        pxHeap[0] = pxHeap[*pSize];
+        prvEventSiftDown( pxHeap, *pSize, 0 );
+    }
+}
+
+/* Remove every event of a task, the heap is rebuilt in place */
+static void prvEventPurge( struct TimedEvent *pxHeap, uint32_t *pSize, uint32_t index )
+{
+    uint32_t i, size = 0;
+    
+    for( i = 0; i < *pSize; i++ )
+    {
+        if( pxHeap[i].index != index )
+            pxHeap[size++] = pxHeap[i];
+    }
+    
+    *pSize = size;
+    for( i = size / 2; i > 0; i-- )
+        prvEventSiftDown( pxHeap, size, i - 1 );
+}
+
+/* Release the next job of a periodic task */
+static void prvTaskRelease( struct Task *pxTask, BaseType_t *pxWoken )
+{
+    UBaseType_t uxSavedMask;
+    
+    /* In the high criticality mode a low criticality task is released once
+     * every TMAN_MC_STRETCH releases, or not at all */
+    if( g_criticality == TMAN_CRIT_HI && pxTask->criticality == TMAN_CRIT_LO )
+    {
+#if( TMAN_MC_STRETCH > 0 )
+        if( ++pxTask->stretchCount < TMAN_MC_STRETCH )
+#endif
+        {
+            pxTask->jobsSkipped++;
+            return;
+        }
+#if( TMAN_MC_STRETCH > 0 )
+        pxTask->stretchCount = 0;
+#endif
+    }
+    
+    if( pxTask->jobsReleased != pxTask->jobsCompleted )
+    {
+        /* An earlier job has not completed, the task picks the activation
+         * up from the backlog when it does */
+        pxTask->overruns++;
+        if( pxTask->overrunPolicy == TMAN_OVERRUN_SKIP || pxTask->backlog >= pxTask->maxBacklog )
+        {
+            pxTask->jobsSkipped++;
+            tmanTRACE( TMAN_TRACE_OVERRUN, pxTask, 0 );
+            return;
+        }
+        
+        if( pxTask->overrunPolicy == TMAN_OVERRUN_ABORT )
+            pxTask->abortRequested = 1;
+        pxTask->backlog++;
+        if( pxTask->backlog > pxTask->backlogMax )
+            pxTask->backlogMax = pxTask->backlog;
+        tmanTRACE( TMAN_TRACE_OVERRUN, pxTask, pxTask->backlog );
+    }
+    else
+    {
+#if( TMAN_USE_JOB_STATS == 1 )
+        prvJobReleased( pxTask );
+#endif
+        prvSignalRelease( pxTask, pxWoken );
+        pxTask->lastActivationTick = g_tmanCurrentTick;
+        pxTask->execute = 1;
+    }
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    prvEdfActivate( pxTask, g_tmanCurrentTick );
+#endif
+    
+    /* Arm the deadline of the new job, TMAN_Start sizes the queue so it
+     * only fills up for task sets that were never started. Sporadic releases
+     * arm it from interrupts too */
+    pxTask->jobsReleased++;
+    
+    /* The release closes the job of a server pacing itself, it is never
+     * seen as an overrun and the idle instants still come */
+    if( tmanSELF_PACED( pxTask ) )
+    {
+        pxTask->jobServed = pxTask->jobsReleased;
+        pxTask->jobsCompleted = pxTask->jobsReleased;
+    }
+    
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if( pxTask->taskDeadline > 0 && g_deadlineHeapSize < TMAN_MAX_DEADLINES )
+    {
+        prvEventInsert( g_deadlineHeap, &g_deadlineHeapSize, g_tmanCurrentTick + pxTask->taskDeadline,
+                ( uint32_t ) ( pxTask - g_arrTask ), pxTask->jobsReleased );
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+    
+    tmanTRACE( TMAN_TRACE_RELEASE, pxTask, pxTask->jobsReleased );
+}
+
+/* Count a missed deadline and report it */
+static void prvDeadlineMissed( struct Task *pxTask, uint32_t lateness )
+{
+#if( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK )
+    UBaseType_t uxSavedMask;
+#endif
+    
+    pxTask->deadlineMisses++;
+    tmanTRACE( TMAN_TRACE_MISS, pxTask, ( lateness > 0xFFFF ) ? 0xFFFF : lateness );
+    
+    if( g_ptrDeadlineMissCallback != NULL ){
+        (*g_ptrDeadlineMissCallback) ( pxTask->pcName, lateness );
+    }
+    else if(g_ptrDeadlineCallback == &TMAN_DeadlineCallback){
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+        (*g_ptrDeadlineCallback) ( pxTask->pcName );
+#else
+        /* Not from the interrupt, the reporter task prints it */
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        pxTask->missesPending++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+#endif
+    }
+    else{
+        (*g_ptrDeadlineCallback)();
+    }
+}
+
+/* Report the expired deadlines of jobs that have not completed */
+static void prvDeadlinesDue( void )
+{
+    struct TimedEvent xEvent;
+    struct Task *pxTask;
+    UBaseType_t uxSavedMask;
+    
+    for( ;; )
+    {
+        /* Sporadic releases insert from interrupts, the miss is reported unmasked */
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        if( g_deadlineHeapSize == 0 || prvTickBefore( g_tmanCurrentTick, g_deadlineHeap[0].tick ) )
+        {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+            break;
+        }
+        xEvent = g_deadlineHeap[0];
+        prvEventPop( g_deadlineHeap, &g_deadlineHeapSize );
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+        
+        pxTask = &g_arrTask[xEvent.index];
+        if( ( int32_t ) ( pxTask->jobsCompleted - xEvent.job ) < 0 )
+            prvDeadlineMissed( pxTask, g_tmanCurrentTick - xEvent.tick );
+    }
+}
+
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE || ( TMAN_MAX_MODES > 0 && TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK ) )
+/* Greatest common divisor, used to compute the hyperperiod */
+static uint32_t prvGcd( uint32_t a, uint32_t b )
+{
+    uint32_t t;
+    
+    while( b != 0 )
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    
+    return a;
+}
+#endif
+
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+/* Release every task listed in the current slot of the hyperperiod */
+static void prvReleaseTableDue( BaseType_t *pxWoken )
+{
+    uint32_t k;
+    struct Task *pxTask;
+    
+    for( k = g_releaseSlotStart[g_releaseSlot]; k < g_releaseSlotStart[g_releaseSlot + 1]; k++ )
+    {
+        pxTask = &g_arrTask[g_releaseList[k]];
+        
+        /* Slots repeat every hyperperiod, the first release waits for the phase */
+        if( g_tmanCurrentTick >= pxTask->taskPhase && pxTask->active )
+            prvTaskRelease( pxTask, pxWoken );
+    }
+    
+    if( ++g_releaseSlot == g_hyperperiod )
+        g_releaseSlot = 0;
+}
+#endif
+
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+/* Release every task at the head of the queue and queue its next release */
+static void prvReleaseQueueDue( BaseType_t *pxWoken )
+{
+    struct Task *pxTask;
+    
+    while( g_releaseHeapSize > 0 && g_releaseHeap[0].tick == g_tmanCurrentTick )
+    {
+        pxTask = &g_arrTask[g_releaseHeap[0].index];
+        prvTaskRelease( pxTask, pxWoken );
+        
+        /* Reuse the root for the next release and push it down */
+        g_releaseHeap[0].tick += pxTask->taskPeriod;
+        prvEventSiftDown( g_releaseHeap, g_releaseHeapSize, 0 );
+    }
+}
+#endif
+
+/* Check every task, the fallback when no release structure is built */
+static void prvReleaseScanDue( BaseType_t *pxWoken )
+{
+    uint32_t i;
+    struct Task *pxTask;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        
+        /* Activate tasks periodically once the phase tick is reached */
+        if( pxTask->taskPeriod != 0 && pxTask->active && g_tmanCurrentTick >= pxTask->taskPhase )
+        {
+            if( ((g_tmanCurrentTick - pxTask->taskPhase) % pxTask->taskPeriod) == 0 )
+                prvTaskRelease( pxTask, pxWoken );
+        }
+    }
+}
+
+/* Release a sporadic job allowed at arrival, with interrupts masked */
+static void prvSporadicRelease( struct Task *pxTask, uint64_t arrival, BaseType_t *pxWoken )
+{
+    pxTask->nextArrival = arrival + pxTask->arrivalSpacing;
+#if( TMAN_USE_JOB_STATS == 1 )
+    pxTask->arrivalTime = arrival;
+#endif
+    prvTaskRelease( pxTask, pxWoken );
+}
+
+/* Release the deferred sporadic jobs whose minimum inter-arrival time elapsed */
+static void prvSporadicDue( BaseType_t *pxWoken )
+{
+    uint32_t i, due;
+    uint64_t arrival = 0;
+    struct Task *pxTask;
+    UBaseType_t uxSavedMask;
+    
+    if( g_deferredReleases == 0 )
+        return;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        
+        /* Only the claim is masked, the release gives the semaphore with the
+         * task level calls when the regulator task runs it. The next arrival
+         * moves on with the claim so an interrupt can not release it again */
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        due = ( pxTask->arrivalDeferred && TMAN_TimebaseGet() >= pxTask->nextArrival );
+        if( due )
+        {
+            pxTask->arrivalDeferred = 0;
+            g_deferredReleases--;
+            arrival = pxTask->nextArrival;
+            pxTask->nextArrival = arrival + pxTask->arrivalSpacing;
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+        
+        if( due )
+            prvSporadicRelease( pxTask, arrival, pxWoken );
+    }
+}
+
+/* The started job of a high criticality task ran past its optimistic budget */
+static uint32_t prvBudgetOverrun( const struct Task *pxTask )
+{
+#if( TMAN_USE_JOB_STATS == 1 )
+    uint32_t cpuTime = pxTask->cpuTime;
+    
+    /* The CPU time of the job running now counts up to its last switch in */
+#if( TMAN_NUM_CORES > 1 )
+    if( pxTask->xTaskHandle != NULL && eTaskGetState( pxTask->xTaskHandle ) == eRunning )
+#else
+    if( pxTask->xTaskHandle == xTaskGetCurrentTaskHandle() )
+#endif
+        cpuTime += ( uint32_t ) ( TMAN_TimebaseGet() - pxTask->switchInTime );
+    
+    return cpuTime > pxTask->taskWcet * ( TMAN_TIMEBASE_HZ / 1000000UL );
+#else
+    /* Without CPU time accounting the time since the release stands in for it */
+    return ( g_tmanCurrentTick - pxTask->lastActivationTick ) * g_tmanTickRateUs > pxTask->taskWcet;
+#endif
+}
+
+/* Enter the high criticality mode, the low criticality jobs already started
+ * are asked to abort. Called with the releases held off */
+static void prvCriticalityRaise( struct Task *pxTask )
+{
+    uint32_t i;
+    
+    g_criticality = TMAN_CRIT_HI;
+    g_mcTrigger = pxTask;
+    g_criticalitySwitches++;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_arrTask[i].criticality != TMAN_CRIT_LO )
+            continue;
+        
+        g_arrTask[i].stretchCount = 0;
+        if( g_arrTask[i].jobServed != g_arrTask[i].jobsCompleted )
+            g_arrTask[i].abortRequested = 1;
+    }
+    
+    tmanTRACE( TMAN_TRACE_CRITICALITY, pxTask, TMAN_CRIT_HI );
+}
+
+/* Watch the budgets of the high criticality jobs in progress, and go back to
+ * the low criticality mode at the first instant no job is pending */
+static void prvCriticalityDue( void )
+{
+    uint32_t i;
+    struct Task *pxTask;
+    
+    if( g_mcTasks == 0 && g_criticality == TMAN_CRIT_LO )
+        return;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        
+        if( g_criticality == TMAN_CRIT_LO )
+        {
+            if( pxTask->criticality == TMAN_CRIT_HI && pxTask->jobServed != pxTask->jobsCompleted &&
+                    prvBudgetOverrun( pxTask ) )
+            {
+                prvCriticalityRaise( pxTask );
+                return;
+            }
+        }
+        else if( pxTask->jobsReleased != pxTask->jobsCompleted || pxTask->backlog != 0 )
+            return;
+    }
+    
+    if( g_criticality == TMAN_CRIT_HI )
+    {
+        g_criticality = TMAN_CRIT_LO;
+        tmanTRACE( TMAN_TRACE_CRITICALITY, g_mcTrigger, TMAN_CRIT_LO );
+    }
+}
+
+static int prvReleaseBuild( void );
+#if( TMAN_NUM_CORES > 1 )
+static void prvAdmissionLoad( struct Task *pxCandidate, uint32_t taskPeriod,
+        uint32_t taskDeadline, uint32_t taskWcet );
+static int prvAdmissionTest( void );
+#endif
+
+/* Rebuild the release structure after the task set changed, before the
+ * releases of a TMAN tick so none of them is made twice or missed */
+#define prvReleaseRebuildDue()      do { if( g_releaseRebuild ) ( void ) prvReleaseBuild(); } while( 0 )
+
+#if( TMAN_MAX_MODES > 0 )
+static void prvModeChangeDue( void );
+#define prvModeChangePending()      ( g_pendingMode != TMAN_MODE_NONE )
+#else
+#define prvModeChangeDue()
+#define prvModeChangePending()      ( 0 )
+#endif
+
+void TMAN_TickHandler( void *pvParam )
+{
+    TickType_t xLastWakeTime;
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+    uint32_t ticksToSleep, nextTick, elapsed;
+#endif
+    
+    /* Initialize the xLastWakeTime variable with the current time */
+    xLastWakeTime = xTaskGetTickCount();
+    g_tmanStartTick = xLastWakeTime;
+#if( TMAN_USE_JOB_STATS == 1 )
+    g_timebaseEpoch = TMAN_TimebaseGet();
+#endif
+    
+    /* TMAN tick k is handled at g_tmanStartTick + (k + 1) TMAN ticks, so
+     * xLastWakeTime is always g_tmanStartTick + g_tmanCurrentTick TMAN ticks */
+    for(;;)
+    {
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+        if( g_releaseMode == TMAN_RELEASE_QUEUE && ( g_releaseHeapSize > 0 || g_deadlineHeapSize > 0 ) )
+        {
+            /* Sleep straight to the earliest pending release or deadline */
+            if( g_releaseHeapSize == 0 || ( g_deadlineHeapSize > 0 &&
+                    prvTickBefore( g_deadlineHeap[0].tick, g_releaseHeap[0].tick ) ) )
+                nextTick = g_deadlineHeap[0].tick;
+            else
+                nextTick = g_releaseHeap[0].tick;
+            
+            /* Sporadic jobs arm deadlines and wait for deferred releases at
+             * any tick, budgets are watched on every tick and a mode change
+             * waits for its safe point */
+            if( g_sporadicTasks != 0 || g_mcTasks != 0 || prvModeChangePending() )
+                nextTick = g_tmanCurrentTick;
+            
+            ticksToSleep = nextTick - g_tmanCurrentTick + 1;
+            vTaskDelayUntil( &xLastWakeTime, (const TickType_t)( ticksToSleep * g_tmanTickInFreeRtosTicks ) );
+            
+            /* Woken early because the task set changed: the skipped ticks had
+             * nothing due, carry on from the current one, which rebuilds */
+            elapsed = ( uint32_t ) ( xTaskGetTickCount() - g_tmanStartTick ) / g_tmanTickInFreeRtosTicks;
+            if( prvTickBefore( elapsed, nextTick + 1 ) )
+            {
+                g_tmanCurrentTick = elapsed;
+                xLastWakeTime = g_tmanStartTick + ( TickType_t ) ( elapsed * g_tmanTickInFreeRtosTicks );
+                continue;
+            }
+            g_tmanCurrentTick = nextTick;
+            
+            /* Wake the whole batch at once, the scheduler then picks the
+             * highest priority job instead of the first one signalled */
+            vTaskSuspendAll();
+            prvReleaseRebuildDue();
+            prvModeChangeDue();
+            prvCriticalityDue();
+            prvDeadlinesDue();
+            if( g_releaseMode == TMAN_RELEASE_QUEUE )
+                prvReleaseQueueDue( NULL );
+            else
+                prvReleaseScanDue( NULL );
+            prvSporadicDue( NULL );
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+            if( g_edfChanged )
+                prvEdfReschedule();
+#endif
+            xTaskResumeAll();
+        }
+        else
+#endif
+        {
+            vTaskDelayUntil( &xLastWakeTime, (const TickType_t)g_tmanTickInFreeRtosTicks );
+            
+            vTaskSuspendAll();
+            prvReleaseRebuildDue();
+            prvModeChangeDue();
+            prvCriticalityDue();
+            prvDeadlinesDue();
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+            if( g_releaseMode == TMAN_RELEASE_TABLE )
+                prvReleaseTableDue( NULL );
+            else
+#elif( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+            /* The queue was just rebuilt after the task set changed */
+            if( g_releaseMode == TMAN_RELEASE_QUEUE )
+                prvReleaseQueueDue( NULL );
+            else
+#endif
+            if( g_releaseMode == TMAN_RELEASE_SCAN )
+                prvReleaseScanDue( NULL );
+            prvSporadicDue( NULL );
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+            if( g_edfChanged )
+                prvEdfReschedule();
+#endif
+            xTaskResumeAll();
+        }
+        
+        g_tmanCurrentTick++;
+    }
+}
+
+void TMAN_TickFromISR( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TICK_HOOK )
+    /* Called on every FreeRTOS tick, act once per TMAN tick */
+    if( ++g_tmanTickDivider < g_tmanTickInFreeRtosTicks )
+        return;
+    g_tmanTickDivider = 0;
+#endif
+    
+#if( TMAN_USE_JOB_STATS == 1 )
+    /* Tick 0 started one TMAN tick before its interrupt */
+    if( g_tmanCurrentTick == 0 )
+        g_timebaseEpoch = TMAN_TimebaseGet() - g_tickCycles;
+#endif
+    
+    /* Same releases as the regulator, TMAN tick k is handled when it ends */
+    prvReleaseRebuildDue();
+    prvCriticalityDue();
+    prvDeadlinesDue();
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+    if( g_releaseMode == TMAN_RELEASE_QUEUE )
+        prvReleaseQueueDue( &xHigherPriorityTaskWoken );
+    else
+#elif( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+    if( g_releaseMode == TMAN_RELEASE_TABLE )
+        prvReleaseTableDue( &xHigherPriorityTaskWoken );
+    else
+#endif
+        prvReleaseScanDue( &xHigherPriorityTaskWoken );
+    prvSporadicDue( &xHigherPriorityTaskWoken );
+    
+    g_tmanCurrentTick++;
+    
+    /* The tick interrupt already switches context when a task was woken */
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+    portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
+#else
+    ( void ) xHigherPriorityTaskWoken;
+#endif
+}
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+void TMAN_TimerInterruptHandler( void )
+{
+    /* Clear the flag before releasing, a yield may not return here soon */
+    IFS0bits.T2IF = 0;
+    TMAN_TickFromISR();
+}
+
+/* Program Timer2 to interrupt once per TMAN tick */
+static int prvTimerSetup( uint32_t tmanTickRateUs )
+{
+    static const uint32_t ulPrescalers[] = { 1, 2, 4, 8, 16, 32, 64, 256 };
+    uint32_t prescaler, counts = 0;
+    
+    /* Smallest prescaler that fits the 16 bit period register */
+    for( prescaler = 0; prescaler < sizeof( ulPrescalers ) / sizeof( ulPrescalers[0] ); prescaler++ )
+    {
+        counts = ( configPERIPHERAL_CLOCK_HZ / 1000000UL ) * tmanTickRateUs / ulPrescalers[prescaler];
+        if( counts <= 0x10000UL )
+            break;
+    }
+    
+    if( counts == 0 || counts > 0x10000UL )
+        return TMAN_INVALID_PARAMETER;
+    
+    T2CONbits.ON = 0; // Stop timer 2
+    IFS0bits.T2IF = 0; // Reset interrupt flag
+    IPC2bits.T2IP = 2; // Must match IPL2AUTO of the vector
+    IEC0bits.T2IE = 1; // Enable T2 interrupts
+    
+    T2CONbits.TCS = 0; // Internal clock
+    T2CONbits.TCKPS = prescaler;
+    T2CONbits.T32 = 0; // 16 bit operation
+    TMR2 = 0;
+    PR2 = counts - 1;
+    
+    /* Interrupts stay masked until the scheduler starts */
+    T2CONbits.ON = 1;
+    
+    return TMAN_SUCCESS;
+}
+#endif
+
+int TMAN_Init( uint32_t tmanTickRateMs , uint32_t stats, void (*ptr)() )
+{
+    return TMAN_InitUs( tmanTickRateMs * 1000UL, stats, ptr );
+}
+
+int TMAN_InitUs( uint32_t tmanTickRateUs , uint32_t stats, void (*ptr)() )
+{
+    /* Verify function parameters */
+    if( tmanTickRateUs <= 0 )
+        return TMAN_INVALID_PARAMETER;
+    
+    if(!( stats == 0 || stats == 1))
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TIMER )
+    /* Only the hardware timer can count fractions of a FreeRTOS tick */
+    if( (tmanTickRateUs % (g_freertosTickRateMs * 1000UL)) != 0 )
+        return TMAN_TICK_RATE_NOT_MULTIPLE_FREERTOS_TICK;
+#endif
+    
+    if (ptr != NULL)
+        g_ptrDeadlineCallback = ptr;
+    else
+        g_ptrDeadlineCallback = &TMAN_DeadlineCallback;
+    
+    /* Initialize Handler */
+    xHandleRegulator = NULL;
+    xHandleReporter = NULL;
+    
+    g_tmanCurrentTick = 0;
+    /* Every record of the pool is free */
+    memset( g_arrTask, 0, sizeof( g_arrTask ) );
+    g_taskCounter = 0;
+    g_tasksInUse = 0;
+    g_sporadicTasks = 0;
+    g_deferredReleases = 0;
+    g_criticality = TMAN_CRIT_LO;
+    g_mcTasks = 0;
+    g_mcTrigger = NULL;
+    g_criticalitySwitches = 0;
+#if( TMAN_MAX_MODES > 0 )
+    memset( g_modeTaskCount, 0, sizeof( g_modeTaskCount ) );
+    g_currentMode = TMAN_MODE_NONE;
+    g_pendingMode = TMAN_MODE_NONE;
+    g_modeStartTick = 0;
+#endif
+#if( tmanUSE_SERVERS )
+    g_serverCount = 0;
+#endif
+#if( tmanUSE_GROUPS )
+    g_groupCount = 0;
+#endif
+#if( TMAN_MAX_RESOURCES > 0 )
+    g_resourceCount = 0;
+#endif
+#if( TMAN_MAX_CHANNELS > 0 )
+    g_channelCount = 0;
+#endif
+    g_releaseMode = TMAN_RELEASE_SCAN;
+    g_releaseRebuild = 0;
+    g_deadlineHeapSize = 0;
+    g_ptrDeadlineMissCallback = NULL;
+    g_tmanTickInFreeRtosTicks = tmanTickRateUs / (g_freertosTickRateMs * 1000UL);
+    g_tmanTickRateUs = tmanTickRateUs;
+#if( TMAN_USE_TRACE == 1 )
+    g_traceHead = 0;
+    g_traceTail = 0;
+#endif
+#if( TMAN_USE_JOB_STATS == 1 )
+    g_tickCycles = tmanTickRateUs * ( TMAN_TIMEBASE_HZ / 1000000UL );
+#endif
+    showStats = stats;
+    
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+    /* Creating the regulator task */    
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+    xHandleRegulator = xTaskCreateStatic( TMAN_TickHandler,
+                    "regulate",
+                    configMINIMAL_STACK_SIZE,
+                    ( void * ) 1,
+                    TMAN_PRIORITY_REGULATOR_TASK,
+                    g_regulatorStack,
+                    &g_regulatorBuffer );
+    if( xHandleRegulator == NULL )
+        return TMAN_NO_MEM;
+#else
+    if( xTaskCreate( TMAN_TickHandler, 
+                    "regulate",
+                    configMINIMAL_STACK_SIZE, 
+                    ( void * ) 1, 
+                    TMAN_PRIORITY_REGULATOR_TASK, 
+                    &xHandleRegulator ) != pdPASS )
+        return TMAN_NO_MEM;
+#endif
+#elif( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TICK_HOOK )
+    g_tmanTickDivider = 0;
+#else
+    if( prvTimerSetup( tmanTickRateUs ) != TMAN_SUCCESS )
+        return TMAN_INVALID_PARAMETER;
+#endif
+    
+    /* Statistics are printed by their own task, off the job path, and so are
+     * the default deadline miss reports without a regulator task */
+    if( showStats || ( TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK && g_ptrDeadlineCallback == &TMAN_DeadlineCallback ) )
+    {
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+        xHandleReporter = xTaskCreateStatic( prvReporterTask,
+                        "report",
+                        TMAN_REPORTER_STACK_SIZE,
+                        NULL,
+                        TMAN_PRIORITY_REPORTER_TASK,
+                        g_reporterStack,
+                        &g_reporterBuffer );
+        if( xHandleReporter == NULL )
+            return TMAN_NO_MEM;
+#else
+        if( xTaskCreate( prvReporterTask,
+                        "report",
+                        TMAN_REPORTER_STACK_SIZE,
+                        NULL,
+                        TMAN_PRIORITY_REPORTER_TASK,
+                        &xHandleReporter ) != pdPASS )
+            return TMAN_NO_MEM;
+#endif
+    }
+    
+    return TMAN_SUCCESS;
+}
+
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+/* Build the hyperperiod release table, one slot per TMAN tick */
+static int prvReleaseTableBuild( void )
+{
+    uint32_t i, slot, hyperperiod = 1, releases = 0;
+    
+    /* Hyperperiod is the LCM of all periods */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_arrTask[i].taskPeriod == 0 || !g_arrTask[i].active )
+            continue;
+        
+        hyperperiod = ( hyperperiod / prvGcd( hyperperiod, g_arrTask[i].taskPeriod ) ) * g_arrTask[i].taskPeriod;
+        if( hyperperiod > TMAN_MAX_HYPERPERIOD )
+            return TMAN_HYPERPERIOD_TOO_LONG;
+    }
+    
+    /* A task is listed in every slot congruent with its phase */
+    for( slot = 0; slot < hyperperiod; slot++ )
+    {
+        g_releaseSlotStart[slot] = releases;
+        
+        for( i = 0; i < g_taskCounter; i++ )
+        {
+            if( g_arrTask[i].taskPeriod == 0 || !g_arrTask[i].active )
+                continue;
+            
+            if( ( slot % g_arrTask[i].taskPeriod ) == ( g_arrTask[i].taskPhase % g_arrTask[i].taskPeriod ) )
+            {
+                if( releases >= TMAN_MAX_RELEASES )
+                    return TMAN_HYPERPERIOD_TOO_LONG;
+                g_releaseList[releases++] = i;
+            }
+        }
+    }
+    
+    g_releaseSlotStart[hyperperiod] = releases;
+    g_hyperperiod = hyperperiod;
+    g_releaseSlot = g_tmanCurrentTick % hyperperiod;
+    
+    return TMAN_SUCCESS;
+}
+
+#endif
+
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+/* Queue the first release of every periodic task at or after the current tick */
+static int prvReleaseQueueBuild( void )
+{
+    uint32_t i, firstRelease;
+    
+    g_releaseHeapSize = 0;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_arrTask[i].taskPeriod == 0 || !g_arrTask[i].active )
+            continue;
+        
+        firstRelease = g_arrTask[i].taskPhase;
+        if( prvTickBefore( firstRelease, g_tmanCurrentTick ) )
+        {
+            firstRelease += ( ( g_tmanCurrentTick - firstRelease + g_arrTask[i].taskPeriod - 1 ) /
+                    g_arrTask[i].taskPeriod ) * g_arrTask[i].taskPeriod;
+        }
+        
+        prvEventInsert( g_releaseHeap, &g_releaseHeapSize, firstRelease, i, 0 );
+    }
+    
+    return TMAN_SUCCESS;
+}
+#endif
+
+/* Build the release structure of the configured mode from the current tick,
+ * scanning until it is built. Called with the releases held off */
+static int prvReleaseBuild( void )
+{
+    int err;
+    
+    g_releaseMode = TMAN_RELEASE_SCAN;
+    g_releaseRebuild = 0;
+    
+#if( TMAN_RELEASE_MODE == TMAN_RELEASE_TABLE )
+    err = prvReleaseTableBuild();
+#elif( TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+    err = prvReleaseQueueBuild();
+#else
+    err = TMAN_SUCCESS;
+#endif
+    
+    if( err == TMAN_SUCCESS )
+        g_releaseMode = TMAN_RELEASE_MODE;
+    
+    return err;
+}
+
+/* The task set changed: scan until the regulator rebuilds the release
+ * structure at its next TMAN tick. Called with the releases held off */
+static void prvReleaseInvalidate( void )
+{
+    if( g_releaseMode != TMAN_RELEASE_SCAN )
+    {
+        g_releaseMode = TMAN_RELEASE_SCAN;
+        g_releaseRebuild = 1;
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK && TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE )
+        /* The regulator may sleep up to the old earliest event, far past
+         * the first release of a task added now */
+        if( xHandleRegulator != NULL && xHandleRegulator != xTaskGetCurrentTaskHandle() )
+            ( void ) xTaskAbortDelay( xHandleRegulator );
+#endif
+    }
+}
+
+int TMAN_Start( void )
+{
+    int err;
+    uint32_t i, deadlineEvents = 0;
+    
+    /* A job keeps its deadline event until the deadline expires */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( prvReleaseSpacing( &g_arrTask[i] ) != 0 && g_arrTask[i].taskDeadline > 0 )
+            deadlineEvents += ( g_arrTask[i].taskDeadline + prvReleaseSpacing( &g_arrTask[i] ) - 1 ) /
+                    prvReleaseSpacing( &g_arrTask[i] );
+    }
+    
+    if( deadlineEvents > TMAN_MAX_DEADLINES )
+        return TMAN_NO_MEM;
+    
+#if( TMAN_NUM_CORES > 1 )
+    /* Place the whole task set again, in decreasing utilization */
+    prvAdmissionLoad( NULL, 0, 0, 0 );
+    for( i = 0; i < g_taskCounter; i++ )
+        g_admission[i].core = TMAN_CORE_ANY;
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+        return err;
+#endif
+    
+    tmanENTER_RELEASE();
+    err = prvReleaseBuild();
+    tmanEXIT_RELEASE();
+    
+    return err;
+}
+
+void TMAN_Close()
+{
+    uint32_t i;
+    
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+    /* Stop the release interrupt */
+    T2CONbits.ON = 0;
+    IEC0bits.T2IE = 0;
+#endif
+    
+    /* Delete regulator task */
+    if( xHandleRegulator != NULL )
+        vTaskDelete( xHandleRegulator );
+    
+    if( xHandleReporter != NULL )
+        vTaskDelete( xHandleReporter );
+    
+#if( tmanUSE_SERVERS )
+    /* Server tasks and queues belong to TMAN */
+    for( i = 0; i < g_serverCount; i++ )
+    {
+        vTaskDelete( g_servers[i].pxTask->xTaskHandle );
+        vQueueDelete( g_servers[i].xQueue );
+    }
+#endif
+    
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+    /* Delete all created semaphores */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( !prvTaskInUse( &g_arrTask[i] ) )
+            continue;
+        vSemaphoreDelete( g_arrTask[i].xSemaphoreHandler );
+        vSemaphoreDelete( g_arrTask[i].xSemaphore );
+    }
+#else
+    ( void ) i;
+#endif
+}
+
+/* Fill a free record with the defaults. A free record is never released,
+ * the regulator skips it while it is filled, every counter starts at 0 */
+static int prvTaskInit( struct Task *pxTask )
+{
+    memset( pxTask, 0, sizeof( *pxTask ) );
+    pxTask->taskPrecedenceConstrains = "";
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+    pxTask->fixedPriority = TMAN_TASK_PRIORITY_LOW;
+#endif
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    pxTask->edfPriority = configMAX_PRIORITIES;
+#endif
+    pxTask->sporadicPolicy = TMAN_SPORADIC_DROP;
+    pxTask->overrunPolicy = TMAN_OVERRUN_QUEUE;
+    pxTask->maxBacklog = TMAN_DEFAULT_BACKLOG;
+    pxTask->active = 1;
+    pxTask->criticality = TMAN_CRIT_LO;
+#if( TMAN_NUM_CORES > 1 )
+    pxTask->core = TMAN_CORE_ANY;
+#endif
+    
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+    pxTask->xSemaphore = xSemaphoreCreateBinaryStatic( &pxTask->xSemaphoreBuffer );
+    pxTask->xSemaphoreHandler = xSemaphoreCreateBinaryStatic( &pxTask->xSemaphoreHandlerBuffer );
+#else
+    /* Initialize precedent semaphore */
+    pxTask->xSemaphore = xSemaphoreCreateBinary();
+    /* Initialize handler semaphore */
+    pxTask->xSemaphoreHandler = xSemaphoreCreateBinary();
+#endif
+    
+    if( pxTask->xSemaphore == NULL || pxTask->xSemaphoreHandler == NULL )
+        return TMAN_NO_MEM;
+#endif
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskAdd( const char *pcName, TMAN_TaskHandle_t *pxTaskHandle )
+{
+    struct Task *pxTask;
+    uint32_t slot;
+    
+    /* Check if task name is already attributed in other task */
+    if( prvTaskFind( pcName ) != NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    /* Lowest free record of the pool, so the loops over the tasks stay short */
+    for( slot = 0; slot < g_taskCounter; slot++ )
+    {
+        if( !prvTaskInUse( &g_arrTask[slot] ) )
+            break;
+    }
+    
+    if( slot >= TMAN_MAX_TASKS )
+        return TMAN_NO_MEM;
+    
+    pxTask = &g_arrTask[slot];
+    if( prvTaskInit( pxTask ) != TMAN_SUCCESS )
+        return TMAN_NO_MEM;
+    
+    /* Publish the record, the regulator may be walking the tasks */
+    tmanENTER_RELEASE();
+    pxTask->pcName = pcName;
+    if( slot == g_taskCounter )
+        g_taskCounter++;
+    g_tasksInUse++;
+    tmanEXIT_RELEASE();
+    
+    if( pxTaskHandle != NULL )
+        *pxTaskHandle = pxTask;
+    
+    return TMAN_SUCCESS;
+}
+
+/* Create the FreeRTOS task of a record and bind it */
+static int prvTaskCreate( struct Task *pxTask, TaskFunction_t pxTaskCode, void *pvParameters,
+        UBaseType_t uxPriority, uint32_t ulStackDepth, StackType_t *puxStackBuffer, StaticTask_t *pxTaskBuffer )
+{
+    TaskHandle_t xHandle = NULL;
+    
+    if( pxTaskCode == NULL || pxTask->xTaskHandle != NULL || ( puxStackBuffer == NULL ) != ( pxTaskBuffer == NULL ) )
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    /* Start at the assigned priority, not the one given */
+    uxPriority = pxTask->fixedPriority;
+#endif
+    
+    if( puxStackBuffer != NULL )
+    {
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        xHandle = xTaskCreateStatic( pxTaskCode, pxTask->pcName, ulStackDepth, pvParameters, uxPriority,
+                puxStackBuffer, pxTaskBuffer );
+#else
+        return TMAN_INVALID_PARAMETER;
+#endif
+    }
+    else
+    {
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+        if( xTaskCreate( pxTaskCode, pxTask->pcName, ulStackDepth, pvParameters, uxPriority, &xHandle ) != pdPASS )
+            xHandle = NULL;
+#else
+        return TMAN_INVALID_PARAMETER;
+#endif
+    }
+    
+    if( xHandle == NULL )
+        return TMAN_NO_MEM;
+    
+    prvTaskBind( pxTask, xHandle );
+    
+    return TMAN_SUCCESS;
+}
+
+/* Create the FreeRTOS task of a record added with TMAN_TaskAdd, in the stack
+ * and TCB storage given or on the heap when both are NULL, and bind it so
+ * the first TMAN_TaskWaitPeriod does not have to */
+int TMAN_TaskCreate( const char *pcName, TaskFunction_t pxTaskCode, void *pvParameters,
+        UBaseType_t uxPriority, uint32_t ulStackDepth, StackType_t *puxStackBuffer, StaticTask_t *pxTaskBuffer )
+{
+    struct Task *pxTask;
+    
+    pxTask = prvTaskFind( pcName );
+    if( pxTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    return prvTaskCreate( pxTask, pxTaskCode, pvParameters, uxPriority, ulStackDepth,
+            puxStackBuffer, pxTaskBuffer );
+}
+
+TMAN_TaskHandle_t TMAN_TaskGetHandle( const char *pcName )
+{
+    return prvTaskFind( pcName );
+}
+
+/* Load the task set into g_admission, pxCandidate taking the given attributes */
+static void prvAdmissionLoad( struct Task *pxCandidate, uint32_t taskPeriod,
+        uint32_t taskDeadline, uint32_t taskWcet )
+{
+    uint32_t i, period, deadline;
+    struct AdmissionTask *pxAdm;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxAdm = &g_admission[i];
+        
+        if( &g_arrTask[i] == pxCandidate )
+        {
+            period = taskPeriod;
+            deadline = taskDeadline;
+            pxAdm->wcet = taskWcet;
+        }
+        else
+        {
+            period = g_arrTask[i].taskPeriod;
+            deadline = g_arrTask[i].taskDeadline;
+            pxAdm->wcet = g_arrTask[i].active ? g_arrTask[i].taskWcet : 0;
+        }
+        
+        /* A sporadic task interferes at most once per minimum inter-arrival time */
+        if( period == 0 )
+            period = g_arrTask[i].minInterArrival;
+        
+        /* No deadline means the next release */
+        if( deadline == 0 )
+            deadline = period;
+        
+        pxAdm->period = period * g_tmanTickRateUs;
+        pxAdm->deadline = deadline * g_tmanTickRateUs;
+        pxAdm->jitter = 0;
+        pxAdm->criticality = g_arrTask[i].criticality;
+        pxAdm->wcetHi = pxAdm->wcet;
+        if( pxAdm->criticality == TMAN_CRIT_HI && pxAdm->wcet != 0 && g_arrTask[i].wcetHi > pxAdm->wcet )
+            pxAdm->wcetHi = g_arrTask[i].wcetHi;
+#if( TMAN_NUM_CORES > 1 )
+        pxAdm->core = g_arrTask[i].core;
+#endif
+#if( tmanUSE_SERVERS )
+        if( g_arrTask[i].pxServer != NULL && g_arrTask[i].pxServer->type == TMAN_SERVER_DEFERRABLE &&
+                pxAdm->period > pxAdm->wcet )
+            pxAdm->jitter = pxAdm->period - pxAdm->wcet;
+#endif
+        
+        /* Monotonic key, tasks without one go last */
+#if( TMAN_PRIORITY_ASSIGNMENT == TMAN_PRIORITY_RM )
+        pxAdm->key = ( period != 0 ) ? period : UINT32_MAX;
+#else
+        pxAdm->key = ( deadline != 0 ) ? deadline : UINT32_MAX;
+#endif
+    }
+}
+
+#if( TMAN_MAX_RESOURCES > 0 )
+/* Longest critical section that can block a job of admission task i: one of
+ * a resource used by a lower priority task whose ceiling reaches task i.
+ * Under EDF the preemption levels order the tasks, the shorter relative
+ * deadline the higher */
+static uint32_t prvAdmissionBlocking( uint32_t i )
+{
+    uint32_t r, u, k, lower, reaches, blocking = 0;
+    const struct Resource *pxResource;
+    
+    for( r = 0; r < g_resourceCount; r++ )
+    {
+        pxResource = &g_resources[r];
+        lower = 0;
+        reaches = 0;
+        
+        for( u = 0; u < pxResource->userCount; u++ )
+        {
+            k = ( uint32_t ) ( pxResource->pxUsers[u] - g_arrTask );
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+            if( g_admission[k].deadline > g_admission[i].deadline )
+                lower = 1;
+            else
+                reaches = 1;
+#else
+            if( g_admission[k].priority < g_admission[i].priority )
+                lower = 1;
+            else
+                reaches = 1;
+#endif
+        }
+        
+        if( lower && reaches && pxResource->csUs > blocking )
+            blocking = pxResource->csUs;
+    }
+    
+    return blocking;
+}
+#else
+#define prvAdmissionBlocking( i )   ( 0 )
+#endif
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+/* Rank the distinct keys and map the ranks onto the priority band. With
+ * manual priorities a task bound to a FreeRTOS task runs at the priority the
+ * application gave it, the rank only stands in for the others */
+static void prvAdmissionPriorities( void )
+{
+    uint32_t i, j, k, rank;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        rank = 0;
+        for( j = 0; j < g_taskCounter; j++ )
+        {
+            if( g_admission[j].key >= g_admission[i].key )
+                continue;
+            
+            /* Count every smaller key once */
+            for( k = 0; k < j; k++ )
+            {
+                if( g_admission[k].key == g_admission[j].key )
+                    break;
+            }
+            if( k == j )
+                rank++;
+        }
+        
+        if( rank < TMAN_TASK_PRIORITY_HIGH - TMAN_TASK_PRIORITY_LOW )
+            g_admission[i].priority = TMAN_TASK_PRIORITY_HIGH - rank;
+        else
+            g_admission[i].priority = TMAN_TASK_PRIORITY_LOW;
+        
+#if( TMAN_PRIORITY_ASSIGNMENT == TMAN_PRIORITY_MANUAL )
+        if( g_arrTask[i].xTaskHandle != NULL )
+            g_admission[i].priority = g_arrTask[i].fixedPriority;
+#endif
+    }
+}
+#endif
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+/* Response time of admission task i, 0 once it exceeds bound. Given the low
+ * criticality response responseLo, the response in the high criticality mode:
+ * the high criticality tasks run for their pessimistic budget and a low
+ * criticality task only interferes with the jobs it released before the
+ * switch, within responseLo, unless it keeps running stretched */
+static uint32_t prvAdmissionResponse( uint32_t i, uint32_t bound, uint32_t blocking, uint32_t responseLo )
+{
+    uint32_t j, wcet, window, response, next;
+    
+    wcet = ( responseLo != 0 ) ? g_admission[i].wcetHi : g_admission[i].wcet;
+    response = wcet + blocking;
+    
+    for( ;; )
+    {
+        if( response > bound )
+            return 0;
+        
+        next = wcet + blocking;
+        for( j = 0; j < g_taskCounter; j++ )
+        {
+            if( j == i || g_admission[j].wcet == 0 || g_admission[j].period == 0 ||
+                    g_admission[j].priority < g_admission[i].priority || !tmanSAME_CORE( i, j ) )
+                continue;
+            
+            window = response;
+            if( responseLo != 0 && g_admission[j].criticality == TMAN_CRIT_LO && TMAN_MC_STRETCH == 0 )
+                window = responseLo;
+            next += ( ( window + g_admission[j].jitter + g_admission[j].period - 1 ) / g_admission[j].period ) *
+                    ( ( responseLo != 0 ) ? g_admission[j].wcetHi : g_admission[j].wcet );
+        }
+        
+        if( next == response )
+            return response;
+        response = next;
+    }
+}
+#endif
+
+/* Schedulability of the tasks in g_admission with a declared WCET, on a
+ * multicore kernel of those placed, each on its core */
+static int prvAdmissionCheck( void )
+{
+    uint32_t i, j, bound, response;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    uint64_t density;
+    uint32_t other;
+    
+    /* Density test, sufficient for EDF with any deadlines. With resources the
+     * tasks up to each bound plus the blocking of that task must fit. High
+     * criticality tasks count with their pessimistic budget in both modes */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_admission[i].wcet == 0 || g_admission[i].period == 0 || !tmanPLACED( i ) )
+            continue;
+        
+        bound = ( g_admission[i].deadline < g_admission[i].period ) ? g_admission[i].deadline : g_admission[i].period;
+        density = ( ( uint64_t ) prvAdmissionBlocking( i ) << 16 ) / bound;
+        
+        for( j = 0; j < g_taskCounter; j++ )
+        {
+            if( g_admission[j].wcet == 0 || g_admission[j].period == 0 || !tmanSAME_CORE( i, j ) )
+                continue;
+            
+            other = ( g_admission[j].deadline < g_admission[j].period ) ? g_admission[j].deadline : g_admission[j].period;
+            if( other <= bound )
+                density += ( ( uint64_t ) g_admission[j].wcetHi << 16 ) / other;
+        }
+        
+        if( density > ( 1UL << 16 ) )
+            return TMAN_NOT_SCHEDULABLE;
+    }
+    
+    ( void ) response;
+#else
+    uint32_t blocking;
+    
+    prvAdmissionPriorities();
+    
+    /* Response time analysis, tasks sharing a priority interfere with each
+     * other, high criticality tasks also in the high criticality mode */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_admission[i].wcet == 0 || g_admission[i].period == 0 || !tmanPLACED( i ) )
+            continue;
+        
+        /* A job must also finish before the next one is released */
+        bound = ( g_admission[i].deadline < g_admission[i].period ) ? g_admission[i].deadline : g_admission[i].period;
+        
+        /* Blocked at most once, by one critical section of a lower priority task */
+        blocking = prvAdmissionBlocking( i );
+        response = prvAdmissionResponse( i, bound, blocking, 0 );
+        if( response == 0 )
+            return TMAN_NOT_SCHEDULABLE;
+        
+        if( g_admission[i].criticality == TMAN_CRIT_HI && prvAdmissionResponse( i, bound, blocking, response ) == 0 )
+            return TMAN_NOT_SCHEDULABLE;
+    }
+    
+    ( void ) j;
+#endif
+    
+    return TMAN_SUCCESS;
+}
+
+#if( TMAN_NUM_CORES > 1 )
+/* Representative of the placement unit of task i */
+static uint32_t prvPartitionUnit( const uint32_t *pUnit, uint32_t i )
+{
+    while( pUnit[i] != i )
+        i = pUnit[i];
+    
+    return i;
+}
+
+static void prvPartitionJoin( uint32_t *pUnit, uint32_t a, uint32_t b )
+{
+    a = prvPartitionUnit( pUnit, a );
+    b = prvPartitionUnit( pUnit, b );
+    if( a < b )
+        pUnit[b] = a;
+    else
+        pUnit[a] = b;
+}
+
+/* Move every task of a unit to a core of g_admission */
+static void prvPartitionMove( const uint32_t *pUnit, uint32_t unit, uint32_t core )
+{
+    uint32_t i;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( prvTaskInUse( &g_arrTask[i] ) && prvPartitionUnit( pUnit, i ) == unit )
+            g_admission[i].core = core;
+    }
+}
+
+/* Place the tasks of g_admission not placed yet. Tasks sharing a rate group
+ * or a resource form one unit, a group task runs all of its members and the
+ * resource ceilings only hold off the tasks of one core. The units go in
+ * decreasing utilization, each on the first core, in TMAN_PARTITION order,
+ * where the admission test passes */
+static int prvPartitionPlace( void )
+{
+    uint32_t unit[TMAN_MAX_TASKS], utilization[TMAN_MAX_TASKS];
+    uint32_t coreUtilization[TMAN_NUM_CORES], coreTasks[TMAN_NUM_CORES];
+    uint32_t i, k, c = 0, pick, tried, count;
+#if( tmanUSE_GROUPS || TMAN_MAX_RESOURCES > 0 )
+    uint32_t m;
+#endif
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        unit[i] = i;
+        utilization[i] = 0;
+    }
+#if( tmanUSE_GROUPS )
+    for( i = 0; i < g_groupCount; i++ )
+    {
+        for( m = 1; m < g_groups[i].memberCount; m++ )
+            prvPartitionJoin( unit, ( uint32_t ) ( g_groups[i].pxMembers[0] - g_arrTask ),
+                    ( uint32_t ) ( g_groups[i].pxMembers[m] - g_arrTask ) );
+    }
+#endif
+#if( TMAN_MAX_RESOURCES > 0 )
+    for( i = 0; i < g_resourceCount; i++ )
+    {
+        for( m = 1; m < g_resources[i].userCount; m++ )
+            prvPartitionJoin( unit, ( uint32_t ) ( g_resources[i].pxUsers[0] - g_arrTask ),
+                    ( uint32_t ) ( g_resources[i].pxUsers[m] - g_arrTask ) );
+    }
+#endif
+    
+    /* A unit formed after its tasks were placed apart is placed again */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        k = prvPartitionUnit( unit, i );
+        if( prvTaskInUse( &g_arrTask[i] ) && g_admission[i].core != g_admission[k].core )
+            prvPartitionMove( unit, k, TMAN_CORE_ANY );
+    }
+    
+    /* Utilization of the units and of the cores, in 1/65536 */
+    for( c = 0; c < TMAN_NUM_CORES; c++ )
+    {
+        coreUtilization[c] = 0;
+        coreTasks[c] = 0;
+    }
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( !prvTaskInUse( &g_arrTask[i] ) )
+            continue;
+        
+        k = ( g_admission[i].period != 0 ) ?
+                ( uint32_t ) ( ( ( uint64_t ) g_admission[i].wcetHi << 16 ) / g_admission[i].period ) : 0;
+        utilization[prvPartitionUnit( unit, i )] += k;
+        if( tmanPLACED( i ) )
+        {
+            coreUtilization[g_admission[i].core] += k;
+            coreTasks[g_admission[i].core]++;
+        }
+    }
+    
+    for( ;; )
+    {
+        /* Unit of the highest utilization not placed yet */
+        pick = TMAN_MAX_TASKS;
+        for( i = 0; i < g_taskCounter; i++ )
+        {
+            if( prvTaskInUse( &g_arrTask[i] ) && unit[i] == i && !tmanPLACED( i ) &&
+                    ( pick == TMAN_MAX_TASKS || utilization[i] > utilization[pick] ) )
+                pick = i;
+        }
+        if( pick == TMAN_MAX_TASKS )
+            break;
+        
+        tried = 0;
+        for( k = 0; k < TMAN_NUM_CORES; k++ )
+        {
+#if( TMAN_PARTITION == TMAN_PARTITION_WORST_FIT )
+            /* Least utilized core not tried yet, then the one with fewer tasks */
+            for( c = TMAN_NUM_CORES, i = 0; i < TMAN_NUM_CORES; i++ )
+            {
+                if( ( tried & ( 1UL << i ) ) == 0 && ( c == TMAN_NUM_CORES || coreUtilization[i] < coreUtilization[c] ||
+                        ( coreUtilization[i] == coreUtilization[c] && coreTasks[i] < coreTasks[c] ) ) )
+                    c = i;
+            }
+#else
+            c = k;
+#endif
+            tried |= 1UL << c;
+            
+            prvPartitionMove( unit, pick, c );
+            if( prvAdmissionCheck() == TMAN_SUCCESS )
+                break;
+        }
+        
+        if( k == TMAN_NUM_CORES )
+        {
+            prvPartitionMove( unit, pick, TMAN_CORE_ANY );
+            return TMAN_NOT_SCHEDULABLE;
+        }
+        
+        for( count = 0, i = 0; i < g_taskCounter; i++ )
+        {
+            if( prvTaskInUse( &g_arrTask[i] ) && prvPartitionUnit( unit, i ) == pick )
+                count++;
+        }
+        coreUtilization[c] += utilization[pick];
+        coreTasks[c] += count;
+    }
+    
+    return prvAdmissionCheck();
+}
+
+/* Keep the placement of an admitted task set, bound tasks move at once */
+static void prvPartitionCommit( void )
+{
+    uint32_t i;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( !prvTaskInUse( &g_arrTask[i] ) || g_arrTask[i].core == g_admission[i].core )
+            continue;
+        
+        g_arrTask[i].core = g_admission[i].core;
+        if( g_arrTask[i].xTaskHandle != NULL && g_arrTask[i].core != TMAN_CORE_ANY )
+            vTaskCoreAffinitySet( g_arrTask[i].xTaskHandle, ( UBaseType_t ) 1 << g_arrTask[i].core );
+    }
+}
+
+/* Place the tasks not placed yet and test the task set, the placement is
+ * kept once it passes */
+static int prvAdmissionTest( void )
+{
+    int err;
+    
+    err = prvPartitionPlace();
+    if( err == TMAN_SUCCESS )
+        prvPartitionCommit();
+    
+    return err;
+}
+#else
+#define prvAdmissionTest()          prvAdmissionCheck()
+#endif
+
+#if( tmanUSE_GROUPS && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+/* Run a group task at the highest assigned priority of its members, which
+ * is then the base priority of each of them */
+static void prvGroupPriority( struct Group *pxGroup )
+{
+    UBaseType_t uxPriority = tskIDLE_PRIORITY;
+    uint32_t m;
+    
+    for( m = 0; m < pxGroup->memberCount; m++ )
+    {
+        if( pxGroup->pxMembers[m]->fixedPriority > uxPriority )
+            uxPriority = pxGroup->pxMembers[m]->fixedPriority;
+    }
+    
+    for( m = 0; m < pxGroup->memberCount; m++ )
+        pxGroup->pxMembers[m]->fixedPriority = uxPriority;
+    
+    if( pxGroup->xTaskHandle != NULL && uxTaskPriorityGet( pxGroup->xTaskHandle ) != uxPriority )
+        vTaskPrioritySet( pxGroup->xTaskHandle, uxPriority );
+}
+#endif
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+/* Give every task its monotonic priority, bound tasks switch immediately */
+static void prvAssignPriorities( void )
+{
+    uint32_t i;
+    
+    prvAdmissionLoad( NULL, 0, 0, 0 );
+    prvAdmissionPriorities();
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+#if( tmanUSE_GROUPS )
+        /* Group tasks take the highest priority of their members below */
+        if( g_arrTask[i].pxGroup != NULL )
+        {
+            g_arrTask[i].fixedPriority = g_admission[i].priority;
+            continue;
+        }
+#endif
+        if( g_arrTask[i].fixedPriority != g_admission[i].priority && g_arrTask[i].xTaskHandle != NULL )
+            vTaskPrioritySet( g_arrTask[i].xTaskHandle, g_admission[i].priority );
+        g_arrTask[i].fixedPriority = g_admission[i].priority;
+    }
+    
+#if( tmanUSE_GROUPS )
+    for( i = 0; i < g_groupCount; i++ )
+        prvGroupPriority( &g_groups[i] );
+#endif
+}
+#endif
+
+int TMAN_TaskSetWcet( const char *pcName, uint32_t wcetUs )
+{
+    return TMAN_TaskSetWcetByHandle( prvTaskFind( pcName ), wcetUs );
+}
+
+int TMAN_TaskSetWcetByHandle( TMAN_TaskHandle_t xTask, uint32_t wcetUs )
+{
+    int err;
+    
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    /* Admit the budget against the registered attributes */
+    prvAdmissionLoad( xTask, xTask->taskPeriod, xTask->taskDeadline, wcetUs );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    xTask->taskWcet = wcetUs;
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskRegisterAttributes(const char *pcName, uint32_t taskPeriod, uint32_t taskPhase,
+        uint32_t taskDeadline, const char *taskPrecedenceConstrains )
+{
+    struct Task *pxTask, *pxPrecedence[TMAN_MAX_PREDECESSORS] = { NULL };
+    uint32_t i, count = 0;
+    int err;
+    
+    if( !strcmp(pcName, taskPrecedenceConstrains) )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* Check if task is already added in framework */
+    pxTask = prvTaskFind( pcName );
+    
+    /* If the task was not added return error code */
+    if( pxTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    err = prvTaskListParse( taskPrecedenceConstrains, pxPrecedence, TMAN_MAX_PREDECESSORS, &count );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    /* A rejected list leaves the edges of the task as they were */
+    err = prvPrecedenceCheck( pxTask, pxPrecedence, count );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    err = TMAN_TaskRegisterAttributesByHandle( pxTask, taskPeriod, taskPhase,
+            taskDeadline, ( count > 0 ) ? pxPrecedence[0] : NULL );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    for( i = 1; i < count; i++ )
+    {
+        err = TMAN_TaskAddPrecedence( pxTask, pxPrecedence[i] );
+        if( err != TMAN_SUCCESS )
+        {
+            /* Do not leave a partial set of predecessors behind */
+            prvPrecedenceClear( pxTask );
+            pxTask->taskPrecedenceConstrains = "";
+            return err;
+        }
+    }
+    
+    pxTask->taskPrecedenceConstrains = taskPrecedenceConstrains;
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskRegisterAttributesByHandle( TMAN_TaskHandle_t xTask, uint32_t taskPeriod,
+        uint32_t taskPhase, uint32_t taskDeadline, TMAN_TaskHandle_t xPrecedence )
+{
+    int err;
+    
+    if( xTask == NULL || xTask == xPrecedence )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* Periods and deadlines must be representable in microseconds */
+    if( taskPeriod > UINT32_MAX / g_tmanTickRateUs || taskDeadline > UINT32_MAX / g_tmanTickRateUs )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* Admit the new attributes and edge before changing anything */
+    if( xPrecedence != NULL )
+    {
+        err = prvPrecedenceCheck( xTask, &xPrecedence, 1 );
+        if( err != TMAN_SUCCESS )
+            return err;
+    }
+    
+    prvAdmissionLoad( xTask, taskPeriod, taskDeadline, xTask->taskWcet );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    /* The predecessor replaces all edges towards the task */
+    prvPrecedenceClear( xTask );
+    xTask->taskPrecedenceConstrains = "";
+    
+    if( xPrecedence != NULL )
+    {
+        err = prvPrecedenceLink( xTask, xPrecedence );
+        if( err != TMAN_SUCCESS )
+            return err;
+        xTask->taskPrecedenceConstrains = xPrecedence->pcName;
+    }
+    
+    /* A task set changed after TMAN_Start scans until the regulator rebuilds
+     * its releases, which must not see half of the attributes */
+    tmanENTER_RELEASE();
+    prvReleaseInvalidate();
+    xTask->taskPeriod = taskPeriod;
+    xTask->taskPhase = taskPhase;
+    xTask->taskDeadline = taskDeadline;
+    tmanEXIT_RELEASE();
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskAddPrecedence( TMAN_TaskHandle_t xTask, TMAN_TaskHandle_t xPredecessor )
+{
+    if( xTask == NULL || xPredecessor == NULL || xTask == xPredecessor )
+        return TMAN_INVALID_PARAMETER;
+    
+    return prvPrecedenceLink( xTask, xPredecessor );
+}
+
+int TMAN_TaskSetSporadic( const char *pcName, uint32_t minInterArrival, uint32_t policy )
+{
+    return TMAN_TaskSetSporadicByHandle( prvTaskFind( pcName ), minInterArrival, policy );
+}
+
+/* Make a task without a period sporadic, its jobs are released by
+ * TMAN_TaskReleaseFromISR at most once every minInterArrival TMAN ticks */
+int TMAN_TaskSetSporadicByHandle( TMAN_TaskHandle_t xTask, uint32_t minInterArrival, uint32_t policy )
+{
+    uint32_t previous;
+    int err;
+    
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    if( xTask->taskPeriod != 0 || minInterArrival == 0 || minInterArrival > UINT32_MAX / g_tmanTickRateUs ||
+            ( policy != TMAN_SPORADIC_DROP && policy != TMAN_SPORADIC_DEFER ) )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* Admit the task as if it were periodic with the minimum inter-arrival time */
+    previous = xTask->minInterArrival;
+    xTask->minInterArrival = minInterArrival;
+    prvAdmissionLoad( NULL, 0, 0, 0 );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+    {
+        xTask->minInterArrival = previous;
+        return err;
+    }
+    
+    tmanENTER_RELEASE();
+    if( previous == 0 )
+        g_sporadicTasks++;
+    xTask->arrivalSpacing = ( uint64_t ) minInterArrival * g_tmanTickRateUs * ( TMAN_TIMEBASE_HZ / 1000000UL );
+    xTask->sporadicPolicy = policy;
+    tmanEXIT_RELEASE();
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    return TMAN_SUCCESS;
+}
+
+/* Release the next job of a sporadic task from an interrupt. A release
+ * earlier than the minimum inter-arrival time is dropped, or with
+ * TMAN_SPORADIC_DEFER postponed to the first TMAN tick after that time,
+ * one at most, further early releases are dropped */
+int TMAN_TaskReleaseFromISR( TMAN_TaskHandle_t xTask, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedMask;
+    uint64_t now;
+    int err = TMAN_SUCCESS;
+    
+    if( xTask == NULL || xTask->taskPeriod != 0 || xTask->minInterArrival == 0 || pxHigherPriorityTaskWoken == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( !xTask->active )
+        return TMAN_FAIL;
+    
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    now = TMAN_TimebaseGet();
+    
+    if( !xTask->arrivalDeferred && now >= xTask->nextArrival )
+    {
+        prvSporadicRelease( xTask, now, pxHigherPriorityTaskWoken );
+    }
+    else if( !xTask->arrivalDeferred && xTask->sporadicPolicy == TMAN_SPORADIC_DEFER )
+    {
+        xTask->arrivalDeferred = 1;
+        xTask->releasesDeferred++;
+        g_deferredReleases++;
+    }
+    else
+    {
+        xTask->releasesDropped++;
+        err = TMAN_RELEASE_TOO_EARLY;
+    }
+    
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+    
+    return err;
+}
+
+int TMAN_TaskSetOverrunPolicy( const char *pcName, uint32_t policy, uint32_t maxBacklog )
+{
+    return TMAN_TaskSetOverrunPolicyByHandle( prvTaskFind( pcName ), policy, maxBacklog );
+}
+
+/* Choose what a release does while an earlier job of the task is not complete */
+int TMAN_TaskSetOverrunPolicyByHandle( TMAN_TaskHandle_t xTask, uint32_t policy, uint32_t maxBacklog )
+{
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    if( policy > TMAN_OVERRUN_ABORT || ( policy == TMAN_OVERRUN_QUEUE && maxBacklog == 0 ) )
+        return TMAN_INVALID_PARAMETER;
+    
+    taskENTER_CRITICAL();
+    xTask->overrunPolicy = policy;
+    /* An aborted job is followed by one activation, a skipped one by none */
+    if( policy == TMAN_OVERRUN_QUEUE )
+        xTask->maxBacklog = maxBacklog;
+    else
+        xTask->maxBacklog = ( policy == TMAN_OVERRUN_ABORT ) ? 1 : 0;
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+}
+
+/* Polled by a job with TMAN_OVERRUN_ABORT, non zero once its next release
+ * arrived, or by a low criticality job once the criticality was raised. It
+ * should then finish early or degrade and call TMAN_TaskWaitPeriod */
+uint32_t TMAN_TaskAbortRequested( TMAN_TaskHandle_t xTask )
+{
+    if( xTask == NULL )
+        return 0;
+    
+    return xTask->abortRequested;
+}
+
+int TMAN_TaskSetCriticality( const char *pcName, uint32_t criticality, uint32_t budgetLoUs, uint32_t budgetHiUs )
+{
+    return TMAN_TaskSetCriticalityByHandle( prvTaskFind( pcName ), criticality, budgetLoUs, budgetHiUs );
+}
+
+/* Criticality of a task and its budgets, the optimistic one replaces the
+ * WCET given to TMAN_TaskSetWcet. A high criticality job running past it
+ * raises the criticality of the system */
+int TMAN_TaskSetCriticalityByHandle( TMAN_TaskHandle_t xTask, uint32_t criticality, uint32_t budgetLoUs,
+        uint32_t budgetHiUs )
+{
+    uint32_t oldCriticality, oldWcetHi;
+    int err;
+    
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    /* The budget of a high criticality task is watched, it must be declared */
+    if( criticality > TMAN_CRIT_HI || ( criticality == TMAN_CRIT_HI && ( budgetLoUs == 0 || budgetHiUs < budgetLoUs ) ) )
+        return TMAN_INVALID_PARAMETER;
+    
+    oldCriticality = xTask->criticality;
+    oldWcetHi = xTask->wcetHi;
+    xTask->criticality = criticality;
+    xTask->wcetHi = ( criticality == TMAN_CRIT_HI ) ? budgetHiUs : budgetLoUs;
+    
+    /* Admit the budgets in both modes against the registered attributes */
+    prvAdmissionLoad( xTask, xTask->taskPeriod, xTask->taskDeadline, budgetLoUs );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+    {
+        xTask->criticality = oldCriticality;
+        xTask->wcetHi = oldWcetHi;
+        return err;
+    }
+    
+    tmanENTER_RELEASE();
+    if( oldCriticality != criticality )
+    {
+        if( criticality == TMAN_CRIT_HI )
+            g_mcTasks++;
+        else
+            g_mcTasks--;
+    }
+    xTask->taskWcet = budgetLoUs;
+    tmanEXIT_RELEASE();
+    
+    return TMAN_SUCCESS;
+}
+
+/* Criticality the system runs at, TMAN_CRIT_HI after a budget overrun */
+uint32_t TMAN_CriticalityGet( void )
+{
+    return g_criticality;
+}
+
+int TMAN_TaskSetActive( const char *pcName, uint32_t active )
+{
+    return TMAN_TaskSetActiveByHandle( prvTaskFind( pcName ), active );
+}
+
+/* Take a task in or out of the released set, mostly used to build the modes */
+int TMAN_TaskSetActiveByHandle( TMAN_TaskHandle_t xTask, uint32_t active )
+{
+    int err;
+    
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    if( active > 1 )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( active && !xTask->active )
+    {
+        xTask->active = 1;
+        prvAdmissionLoad( NULL, 0, 0, 0 );
+        err = prvAdmissionTest();
+        if( err != TMAN_SUCCESS )
+        {
+            xTask->active = 0;
+            return err;
+        }
+    }
+    
+    /* A task set changed after TMAN_Start scans until the regulator rebuilds its releases */
+    tmanENTER_RELEASE();
+    xTask->active = active;
+    prvReleaseInvalidate();
+    tmanEXIT_RELEASE();
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskRemove( const char *pcName )
+{
+    return TMAN_TaskRemoveByHandle( prvTaskFind( pcName ) );
+}
+
+/* Retire a task while TMAN runs and hand its record back to the pool. Its
+ * FreeRTOS task is deleted and a job in progress is dropped without a
+ * deadline miss. A task that is still the predecessor of another one, uses
+ * a resource or a channel, runs a server or is in a rate group stays. A task removing itself does not return */
+int TMAN_TaskRemoveByHandle( TMAN_TaskHandle_t xTask )
+{
+    TaskHandle_t xHandle;
+    UBaseType_t uxSavedMask;
+    uint32_t slot;
+#if( TMAN_MAX_MODES > 0 || TMAN_MAX_RESOURCES > 0 || TMAN_MAX_CHANNELS > 0 )
+    uint32_t i, k;
+#endif
+#if( TMAN_MAX_MODES > 0 )
+    uint32_t mode;
+    struct ModeTask *pxMode;
+#endif
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+    SemaphoreHandle_t xSemaphore, xSemaphoreHandler;
+#endif
+    
+    if( xTask == NULL || !prvTaskInUse( xTask ) )
+        return TMAN_INVALID_TASK_NAME;
+    
+    if( xTask->successorCount != 0 )
+        return TMAN_TASK_IN_USE;
+#if( tmanUSE_SERVERS )
+    if( xTask->pxServer != NULL )
+        return TMAN_TASK_IN_USE;
+#endif
+#if( tmanUSE_GROUPS )
+    if( xTask->pxGroup != NULL )
+        return TMAN_TASK_IN_USE;
+#endif
+#if( TMAN_MAX_RESOURCES > 0 )
+    for( i = 0; i < g_resourceCount; i++ )
+    {
+        for( k = 0; k < g_resources[i].userCount; k++ )
+        {
+            if( g_resources[i].pxUsers[k] == xTask )
+                return TMAN_TASK_IN_USE;
+        }
+    }
+#endif
+#if( TMAN_MAX_CHANNELS > 0 )
+    for( i = 0; i < g_channelCount; i++ )
+    {
+        if( g_channels[i].pxProducer == xTask || g_channels[i].pxConsumer == xTask )
+            return TMAN_TASK_IN_USE;
+    }
+#endif
+    
+    slot = ( uint32_t ) ( xTask - g_arrTask );
+    xHandle = xTask->xTaskHandle;
+    
+    /* Take the task out of every release path first */
+    tmanENTER_RELEASE();
+    prvPrecedenceClear( xTask );
+    if( xTask->minInterArrival != 0 )
+        g_sporadicTasks--;
+    if( xTask->criticality == TMAN_CRIT_HI )
+        g_mcTasks--;
+    
+    uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if( xTask->arrivalDeferred )
+        g_deferredReleases--;
+    xTask->active = 0;
+    xTask->taskPeriod = 0;
+    xTask->minInterArrival = 0;
+    xTask->arrivalDeferred = 0;
+    prvEventPurge( g_deadlineHeap, &g_deadlineHeapSize, slot );
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+    
+    prvReleaseInvalidate();
+    
+#if( TMAN_MAX_MODES > 0 )
+    /* A record reused later is inactive in the saved modes, and no saved
+     * mode links a task to it */
+    for( mode = 0; mode < TMAN_MAX_MODES; mode++ )
+    {
+        for( i = 0; i < g_modeTaskCount[mode]; i++ )
+        {
+            pxMode = &g_modes[mode][i];
+            if( i == slot )
+            {
+                memset( pxMode, 0, sizeof( *pxMode ) );
+                continue;
+            }
+            
+            for( k = 0; k < pxMode->predecessorCount; k++ )
+            {
+                if( pxMode->pxPredecessors[k] == xTask )
+                    pxMode->pxPredecessors[k--] = pxMode->pxPredecessors[--pxMode->predecessorCount];
+            }
+        }
+    }
+#endif
+    tmanEXIT_RELEASE();
+    
+    /* The task may be blocked on its semaphores, delete it before them */
+    if( xHandle != NULL && xHandle != xTaskGetCurrentTaskHandle() )
+        vTaskDelete( xHandle );
+    
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+    xSemaphore = xTask->xSemaphore;
+    xSemaphoreHandler = xTask->xSemaphoreHandler;
+#endif
+    
+    /* Free the record, and the records left at the end of the pool. The
+     * switch hooks of a task removing itself must not reach it any more */
+    tmanENTER_RELEASE();
+    if( xHandle != NULL && xHandle == xTaskGetCurrentTaskHandle() )
+        vTaskSetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX, NULL );
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    xTask->edfActive = 0;
+#endif
+    memset( xTask, 0, sizeof( *xTask ) );
+    g_tasksInUse--;
+    while( g_taskCounter > 0 && !prvTaskInUse( &g_arrTask[g_taskCounter - 1] ) )
+        g_taskCounter--;
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    /* The other jobs move up the EDF band */
+    prvEdfReschedule();
+#endif
+    tmanEXIT_RELEASE();
+    
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+    vSemaphoreDelete( xSemaphore );
+    vSemaphoreDelete( xSemaphoreHandler );
+#endif
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    if( xHandle != NULL && xHandle == xTaskGetCurrentTaskHandle() )
+        vTaskDelete( NULL );
+    
+    return TMAN_SUCCESS;
+}
+
+/* Add a task set described at compile time, see tmantaskset.h. The set
+ * takes the records after the last one in use, in its order, so indices
+ * give the predecessors and no name is looked up. The build already checked
+ * the references, cycles and utilization, the admission test still checks
+ * the response times of the tasks with a WCET. Tasks with a task function
+ * get their FreeRTOS task in the storage of their entry */
+int TMAN_TaskSetLoad( const TMAN_TaskSetEntry_t *pxSet, uint32_t count )
+{
+    struct Task *pxTask;
+    uint32_t base, i, k;
+    int err = TMAN_SUCCESS;
+    
+    if( pxSet == NULL || count == 0 )
+        return TMAN_INVALID_PARAMETER;
+    
+    base = g_taskCounter;
+    if( count > TMAN_MAX_TASKS - base )
+        return TMAN_NO_MEM;
+    
+    for( i = 0; i < count && err == TMAN_SUCCESS; i++ )
+    {
+        pxTask = &g_arrTask[base + i];
+        err = prvTaskInit( pxTask );
+        if( err != TMAN_SUCCESS )
+        {
+            i++;
+            break;
+        }
+        
+        pxTask->taskPeriod = pxSet[i].period;
+        pxTask->taskPhase = pxSet[i].phase;
+        pxTask->taskDeadline = pxSet[i].deadline;
+        pxTask->taskWcet = pxSet[i].wcetUs;
+        for( k = 0; k < pxSet[i].predecessorCount && err == TMAN_SUCCESS; k++ )
+        {
+            /* Only an earlier entry, a set can not hold a cycle */
+            if( pxSet[i].predecessorCount > TMAN_MAX_PREDECESSORS || pxSet[i].predecessors[k] >= i )
+                err = TMAN_INVALID_PARAMETER;
+            else
+                err = prvPrecedenceLink( pxTask, &g_arrTask[base + pxSet[i].predecessors[k]] );
+        }
+        if( err != TMAN_SUCCESS )
+        {
+            i++;
+            break;
+        }
+        if( pxSet[i].predecessorCount > 0 )
+            pxTask->taskPrecedenceConstrains = pxSet[i].pcPrecedence;
+    }
+    if( err != TMAN_SUCCESS )
+    {
+        /* Nothing was published, hand back what the records took */
+#if( TMAN_USE_TASK_NOTIFICATIONS == 0 )
+        while( i-- > 0 )
+        {
+            if( g_arrTask[base + i].xSemaphore != NULL )
+                vSemaphoreDelete( g_arrTask[base + i].xSemaphore );
+            if( g_arrTask[base + i].xSemaphoreHandler != NULL )
+                vSemaphoreDelete( g_arrTask[base + i].xSemaphoreHandler );
+        }
+#endif
+        memset( &g_arrTask[base], 0, count * sizeof( struct Task ) );
+        return err;
+    }
+    
+    /* Publish the whole set at once, the regulator may be walking the tasks */
+    tmanENTER_RELEASE();
+    for( i = 0; i < count; i++ )
+        g_arrTask[base + i].pcName = pxSet[i].pcName;
+    g_taskCounter = base + count;
+    g_tasksInUse += count;
+    prvReleaseInvalidate();
+    tmanEXIT_RELEASE();
+    
+    prvAdmissionLoad( NULL, 0, 0, 0 );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+    {
+        /* Successors come after their predecessors, remove them first */
+        for( i = count; i > 0; i-- )
+            ( void ) TMAN_TaskRemoveByHandle( &g_arrTask[base + i - 1] );
+        return err;
+    }
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    for( i = 0; i < count; i++ )
+    {
+        if( pxSet[i].pxTaskCode == NULL )
+            continue;
+        
+        err = prvTaskCreate( &g_arrTask[base + i], pxSet[i].pxTaskCode, pxSet[i].pvParameters,
+                pxSet[i].uxPriority, pxSet[i].ulStackDepth, pxSet[i].puxStackBuffer, pxSet[i].pxTaskBuffer );
+        if( err != TMAN_SUCCESS )
+            return err;
+    }
+    
+    return TMAN_SUCCESS;
+}
+
+#if( TMAN_MAX_MODES > 0 )
+/* A task whose attributes differ between two modes, every task differs from no mode */
+static uint32_t prvModeTaskChanged( uint32_t i, uint32_t from, uint32_t to )
+{
+    const struct ModeTask *pxFrom, *pxTo;
+    uint32_t k;
+    
+    if( from == TMAN_MODE_NONE || i >= g_modeTaskCount[from] || i >= g_modeTaskCount[to] )
+        return 1;
+    
+    pxFrom = &g_modes[from][i];
+    pxTo = &g_modes[to][i];
+    if( pxFrom->active != pxTo->active || pxFrom->period != pxTo->period || pxFrom->phase != pxTo->phase ||
+            pxFrom->deadline != pxTo->deadline || pxFrom->predecessorCount != pxTo->predecessorCount )
+        return 1;
+    
+    for( k = 0; k < pxTo->predecessorCount; k++ )
+    {
+        if( pxFrom->pxPredecessors[k] != pxTo->pxPredecessors[k] )
+            return 1;
+    }
+    
+    return 0;
+}
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+/* Hyperperiod of the active periodic tasks, 0 when it does not fit */
+static uint32_t prvModeHyperperiod( void )
+{
+    uint32_t i, gcd;
+    uint64_t hyperperiod = 1;
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        if( g_arrTask[i].taskPeriod == 0 || !g_arrTask[i].active )
+            continue;
+        
+        gcd = prvGcd( ( uint32_t ) hyperperiod, g_arrTask[i].taskPeriod );
+        hyperperiod = ( hyperperiod / gcd ) * g_arrTask[i].taskPeriod;
+        if( hyperperiod > UINT32_MAX / 2 )
+            return 0;
+    }
+    
+    return ( uint32_t ) hyperperiod;
+}
+#endif
+
+/* Switch to a saved mode at the current tick, before its releases. Tasks
+ * with the same attributes in both modes keep their jobs and releases, the
+ * phases of the others count from this tick */
+static void prvModeApply( uint32_t mode )
+{
+    static const struct ModeTask xInactive = { 0 };
+    uint8_t changed[TMAN_MAX_TASKS];
+    const struct ModeTask *pxMode;
+    struct Task *pxTask;
+    uint32_t i, k;
+    
+    /* Drop the old edges first, so every intermediate graph is a subgraph
+     * of the new one and the links below cannot make a cycle */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        changed[i] = ( uint8_t ) prvModeTaskChanged( i, g_currentMode, mode );
+        if( changed[i] )
+            prvPrecedenceClear( &g_arrTask[i] );
+    }
+    
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        if( !changed[i] || !prvTaskInUse( pxTask ) )
+            continue;
+        
+        pxMode = ( i < g_modeTaskCount[mode] ) ? &g_modes[mode][i] : &xInactive;
+        
+        pxTask->active = pxMode->active;
+        pxTask->taskPeriod = pxMode->period;
+        pxTask->taskPhase = g_tmanCurrentTick + pxMode->phase;
+        pxTask->taskDeadline = pxMode->deadline;
+        pxTask->taskPrecedenceConstrains = ( pxMode->precedence != NULL ) ? pxMode->precedence : "";
+        for( k = 0; k < pxMode->predecessorCount; k++ )
+            ( void ) prvPrecedenceLink( pxTask, pxMode->pxPredecessors[k] );
+    }
+    
+    /* A task that only precedence releases may be waiting for a release
+     * since it was deactivated, let it go on to wait for its predecessors */
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        if( changed[i] && pxTask->waitingActivation && pxTask->active && prvReleaseSpacing( pxTask ) == 0 )
+            prvSignalRelease( pxTask, NULL );
+    }
+    
+    g_currentMode = mode;
+    g_modeStartTick = g_tmanCurrentTick;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED && TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvAssignPriorities();
+#endif
+    
+    ( void ) prvReleaseBuild();
+}
+
+/* Apply the pending mode change once its safe point is reached, called by
+ * the regulator before the releases of each TMAN tick */
+static void prvModeChangeDue( void )
+{
+    uint32_t i, mode;
+    
+    if( g_pendingMode == TMAN_MODE_NONE )
+        return;
+    
+    if( g_pendingWhen == TMAN_MODE_AT_HYPERPERIOD )
+    {
+        if( prvTickBefore( g_tmanCurrentTick, g_modeBoundary ) )
+            return;
+    }
+    else
+    {
+        /* Every task the change affects has completed its jobs */
+        for( i = 0; i < g_taskCounter; i++ )
+        {
+            if( prvModeTaskChanged( i, g_currentMode, g_pendingMode ) &&
+                    ( g_arrTask[i].jobsReleased != g_arrTask[i].jobsCompleted || g_arrTask[i].backlog != 0 ) )
+                return;
+        }
+    }
+    
+    mode = g_pendingMode;
+    g_pendingMode = TMAN_MODE_NONE;
+    prvModeApply( mode );
+}
+#endif
+
+/* Save the attributes of every task as a mode, TMAN_ModeChange switches to
+ * it later. The task set was admitted when the attributes were registered */
+int TMAN_ModeSave( uint32_t mode )
+{
+#if( TMAN_MAX_MODES > 0 )
+    struct ModeTask *pxMode;
+    struct Task *pxTask;
+    uint32_t i, k;
+    
+    if( mode >= TMAN_MAX_MODES )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* The regulator reads the modes while a change is pending */
+    vTaskSuspendAll();
+    for( i = 0; i < g_taskCounter; i++ )
+    {
+        pxTask = &g_arrTask[i];
+        pxMode = &g_modes[mode][i];
+        
+        pxMode->active = pxTask->active;
+        pxMode->period = pxTask->taskPeriod;
+        /* Live phases are absolute ticks, keep the first release at or
+         * after the start of the current mode relative to it */
+        if( pxTask->taskPhase >= g_modeStartTick )
+            pxMode->phase = pxTask->taskPhase - g_modeStartTick;
+        else if( pxTask->taskPeriod != 0 )
+            pxMode->phase = ( pxTask->taskPeriod - ( g_modeStartTick - pxTask->taskPhase ) % pxTask->taskPeriod ) % pxTask->taskPeriod;
+        else
+            pxMode->phase = 0;
+        pxMode->deadline = pxTask->taskDeadline;
+        pxMode->precedence = pxTask->taskPrecedenceConstrains;
+        pxMode->predecessorCount = pxTask->predecessorCount;
+        for( k = 0; k < pxTask->predecessorCount; k++ )
+            pxMode->pxPredecessors[k] = pxTask->pxPredecessors[k];
+    }
+    g_modeTaskCount[mode] = g_taskCounter;
+    
+    /* The live attributes are the saved mode until they are changed again */
+    g_currentMode = mode;
+    ( void ) xTaskResumeAll();
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Switch to a saved mode. Before the scheduler starts it applies at once,
+ * afterwards at the next hyperperiod boundary of the current mode, or with
+ * TMAN_MODE_WHEN_IDLE at the first TMAN tick the tasks it changes have no
+ * job in progress. A new request replaces a pending one */
+int TMAN_ModeChange( uint32_t mode, uint32_t when )
+{
+#if( TMAN_MAX_MODES > 0 )
+    uint32_t hyperperiod, tick;
+    
+    if( mode >= TMAN_MAX_MODES || g_modeTaskCount[mode] == 0 ||
+            ( when != TMAN_MODE_AT_HYPERPERIOD && when != TMAN_MODE_WHEN_IDLE ) )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+    {
+        prvModeApply( mode );
+        return TMAN_SUCCESS;
+    }
+    
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK )
+    vTaskSuspendAll();
+    
+    hyperperiod = prvModeHyperperiod();
+    if( when == TMAN_MODE_AT_HYPERPERIOD && hyperperiod == 0 )
+        when = TMAN_MODE_WHEN_IDLE;
+    
+    /* First boundary the regulator has not handled yet */
+    tick = prvTmanGetTick();
+    if( hyperperiod != 0 )
+        g_modeBoundary = g_modeStartTick + ( ( tick - g_modeStartTick + hyperperiod - 1 ) / hyperperiod ) * hyperperiod;
+    g_pendingWhen = when;
+    g_pendingMode = mode;
+    
+    ( void ) xTaskResumeAll();
+    
+    return TMAN_SUCCESS;
+#else
+    /* Priorities change with the mode, only the regulator task can switch */
+    ( void ) hyperperiod; ( void ) tick;
+    return TMAN_FAIL;
+#endif
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Current mode, TMAN_MODE_NONE before the first one is saved or applied */
+uint32_t TMAN_ModeGet( void )
+{
+#if( TMAN_MAX_MODES > 0 )
+    return g_currentMode;
+#else
+    return TMAN_MODE_NONE;
+#endif
+}
+
+int TMAN_TaskGetTopologicalOrder( TMAN_TaskHandle_t *pxOrder, uint32_t maxTasks )
+{
+    uint8_t pending[TMAN_MAX_TASKS];
+    uint32_t i, k, count = 0;
+    struct Task *pxTask;
+    
+    if( pxOrder == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( maxTasks < g_tasksInUse )
+        return TMAN_NO_MEM;
+    
+    /* Free records are never listed */
+    for( i = 0; i < g_taskCounter; i++ )
+        pending[i] = prvTaskInUse( &g_arrTask[i] ) ? ( uint8_t ) g_arrTask[i].predecessorCount : UINT8_MAX;
+    
+    while( count < g_tasksInUse )
+    {
+        /* Lowest index task whose predecessors are all listed, ties follow
+         * the order the tasks were added */
+        for( i = 0; i < g_taskCounter; i++ )
+        {
+            if( pending[i] == 0 )
+                break;
+        }
+        
+        /* Unreachable while prvPrecedenceLink refuses cycles */
+        if( i == g_taskCounter )
+            return TMAN_PRECEDENCE_CYCLE;
+        
+        pxTask = &g_arrTask[i];
+        pending[i] = UINT8_MAX;
+        pxOrder[count++] = pxTask;
+        
+        for( k = 0; k < pxTask->successorCount; k++ )
+            pending[pxTask->pxSuccessors[k] - g_arrTask]--;
+    }
+    
+    return ( int ) count;
+}
+
+int TMAN_TaskWaitPeriod( char *pcName )
+{
+    struct Task *pxTask;
+    
+    /* Calls after the first one resolve the record through the TLS pointer */
+    pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    
+    if( pxTask == NULL || ( pxTask->pcName != pcName && strcmp(pxTask->pcName, pcName) ) )
+        pxTask = prvTaskFind( pcName );
+    
+    if( pxTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    return TMAN_TaskWaitPeriodByHandle( pxTask );
+}
+
+int TMAN_TaskWaitPeriodSelf( void )
+{
+    struct Task *pxTask;
+    
+    pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    
+    /* First call: find the record through the FreeRTOS task name */
+    if( pxTask == NULL )
+    {
+        pxTask = prvTaskFind( pcTaskGetName( NULL ) );
+        if( pxTask == NULL )
+            return TMAN_INVALID_TASK_NAME;
+    }
+    
+    return TMAN_TaskWaitPeriodByHandle( pxTask );
+}
+
+/* The job of the calling task completed: account for it and signal it to
+ * the tasks that depend on it */
+static void prvJobEnd( struct Task *pxTask, uint32_t currentTick )
+{
+    /* The job that called us is complete, its deadline event is disarmed */
+    if( pxTask->taskActivations != 0 )
+    {
+        /* An overrun of the optimistic budget between two TMAN ticks still
+         * raises the criticality */
+        if( pxTask->criticality == TMAN_CRIT_HI && prvBudgetOverrun( pxTask ) )
+        {
+            tmanENTER_RELEASE();
+            if( g_criticality == TMAN_CRIT_LO )
+                prvCriticalityRaise( pxTask );
+            tmanEXIT_RELEASE();
+        }
+#if( TMAN_USE_JOB_STATS == 1 )
+        /* Only jobs released by TMAN have a release time. It is read before
+         * the completion is published, the next release overwrites it */
+        if( prvReleaseSpacing( pxTask ) != 0 || pxTask->predecessorCount != 0 )
+            prvJobCompleted( pxTask );
+#endif
+        pxTask->jobsCompleted = pxTask->jobServed;
+        tmanTRACE( TMAN_TRACE_COMPLETE, pxTask, prvJobNumber( pxTask ) );
+    }
+    
+    /* Jobs released by precedence only have no deadline event, check them here */
+    if( pxTask->taskActivations != 0 && pxTask->taskDeadline > 0 && prvReleaseSpacing( pxTask ) == 0 )
+    {
+        if( (pxTask->lastActivationTick + pxTask->taskDeadline) < (currentTick - 1) )
+            prvDeadlineMissed( pxTask, currentTick - 1 - pxTask->lastActivationTick - pxTask->taskDeadline );
+    }
+    
+#if( TMAN_MAX_CHANNELS > 0 )
+    /* Data of the job goes out before its successors are released */
+    if( pxTask->taskActivations != 0 )
+        prvChannelPublish( pxTask );
+#endif
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    /* Keep the regulator out while the active jobs change */
+    vTaskSuspendAll();
+#endif
+    
+    /* Don't do a give if it is the first tick */
+    if( currentTick != 0 )
+        prvSignalCompletion( pxTask );
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    if( pxTask->taskActivations != 0 )
+        prvEdfComplete( pxTask );
+    
+    /* Also applies the EDF priority to a task bound on this call */
+    prvEdfReschedule();
+    ( void ) xTaskResumeAll();
+#endif
+}
+
+/* Block the calling task until the next job of a task is released and its
+ * predecessors completed, then start it */
+static void prvJobBegin( struct Task *pxTask, uint32_t currentTick )
+{
+    uint32_t backlogged;
+#if( TMAN_USE_JOB_STATS == 1 )
+    uint64_t now;
+#endif
+    
+    /* Task is suspended until the regulator or an interrupt releases it,
+     * unless an activation queued while the last job overran */
+    if( prvReleaseSpacing( pxTask ) != 0 || !pxTask->active )
+    {
+        taskENTER_CRITICAL();
+        backlogged = ( pxTask->backlog != 0 );
+        if( backlogged )
+            pxTask->backlog--;
+        taskEXIT_CRITICAL();
+        
+        if( backlogged )
+        {
+            /* The queued job was released one spacing after the previous one */
+            pxTask->lastActivationTick += prvReleaseSpacing( pxTask );
+            pxTask->execute = 1;
+#if( TMAN_USE_JOB_STATS == 1 )
+            /* It was queued by now, a late release of the previous job would
+             * put the estimate past it */
+            pxTask->releaseTime += ( uint64_t ) prvReleaseSpacing( pxTask ) * g_tickCycles;
+            now = TMAN_TimebaseGet();
+            if( pxTask->releaseTime > now )
+                pxTask->releaseTime = now;
+#endif
+        }
+        else
+        {
+            pxTask->waitingActivation = !pxTask->active;
+            prvWaitRelease( pxTask, portMAX_DELAY );
+            pxTask->waitingActivation = 0;
+        }
+    }
+    
+    /* A task with predecessors also waits for all of them to complete */
+    if( pxTask->predecessorCount != 0 )
+    {
+        if( pxTask->execute == 0 && prvReleaseSpacing( pxTask ) != 0)
+        {
+            pxTask->lastActivationTick = currentTick-1;
+            pxTask->execute = 1;
+        }
+        tmanTRACE( TMAN_TRACE_PRECEDENCE_WAIT, pxTask, pxTask->predecessorsDone );
+        prvWaitPrecedence( pxTask );
+        if( pxTask->execute == 0 && prvReleaseSpacing( pxTask ) == 0)
+        {
+            pxTask->lastActivationTick = currentTick-1;
+            pxTask->execute = 1;
+        }
+    }
+    
+    /* Jobs are served in release order, the abort request was for the previous one */
+    pxTask->taskActivations++;
+    pxTask->execute = 0;
+    pxTask->abortRequested = 0;
+    pxTask->jobServed = ( prvReleaseSpacing( pxTask ) != 0 ) ? pxTask->jobsCompleted + 1 : pxTask->jobsReleased;
+    tmanTRACE( TMAN_TRACE_START, pxTask, prvJobNumber( pxTask ) );
+    
+#if( TMAN_MAX_CHANNELS > 0 )
+    prvChannelTake( pxTask );
+#endif
+    
+#if( TMAN_USE_JOB_STATS == 1 )
+    if( prvReleaseSpacing( pxTask ) != 0 || pxTask->predecessorCount != 0 )
+        prvJobStarted( pxTask );
+#endif
+}
+
+int TMAN_TaskWaitPeriodByHandle( TMAN_TaskHandle_t xTask )
+{
+    uint32_t currentTick;
+    
+    if( xTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    currentTick = prvTmanGetTick();
+    
+    if( xTask->xTaskHandle == NULL )
+        prvTaskBind( xTask, xTaskGetCurrentTaskHandle() );
+    
+    prvJobEnd( xTask, currentTick );
+    prvJobBegin( xTask, currentTick );
     
     /* We can check if the task passed it's deadline here */
     return TMAN_SUCCESS;
-}
\ No newline at end of file
+}
+
+#if( tmanUSE_GROUPS )
+/* Task of a rate group: each member job in turn waits for its release and
+ * predecessors, runs and completes like a task of its own. The thread local
+ * pointer follows the member so its CPU time and locks are its own */
+static void prvGroupTask( void *pvParameters )
+{
+    struct Group *pxGroup = ( struct Group * ) pvParameters;
+    struct Task *pxTask;
+    uint32_t m, active;
+    
+    for( ;; )
+    {
+        for( m = 0; m < pxGroup->memberCount; m++ )
+        {
+            pxTask = pxGroup->pxMembers[m];
+            
+            /* Members a mode deactivated are skipped while another one is
+             * active, a group with none active waits on the next in turn */
+            if( !pxTask->active )
+            {
+                for( active = 0; active < pxGroup->memberCount && !pxGroup->pxMembers[active]->active; active++ )
+                    ;
+                if( active < pxGroup->memberCount )
+                    continue;
+            }
+            
+            vTaskSetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX, ( void * ) pxTask );
+            prvJobBegin( pxTask, prvTmanGetTick() );
+            pxTask->pxJob( pxTask->pvJobArg );
+            prvJobEnd( pxTask, prvTmanGetTick() );
+        }
+    }
+}
+#endif
+
+/* Job function a rate group calls for each job of the task */
+int TMAN_TaskSetJob( const char *pcName, TMAN_Job_t pxJob, void *pvArg )
+{
+#if( tmanUSE_GROUPS )
+    struct Task *pxTask;
+    
+    pxTask = prvTaskFind( pcName );
+    if( pxTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    if( pxJob == NULL || pxTask->pxGroup != NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    pxTask->pxJob = pxJob;
+    pxTask->pvJobArg = pvArg;
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Fuse a comma separated list of periodic tasks of equal period into one
+ * FreeRTOS task, in place of a TMAN_TaskCreate for each. Members need a job
+ * function and no task of their own. Jobs run in precedence order, then by
+ * phase and priority. A precedence chain that leaves a group and comes back
+ * to it through another group can deadlock both, keep such chains in one */
+int TMAN_GroupCreate( const char *pcName, const char *pcMembers, UBaseType_t uxPriority,
+        uint32_t ulStackDepth, StackType_t *puxStackBuffer, StaticTask_t *pxTaskBuffer )
+{
+#if( tmanUSE_GROUPS )
+    struct Task *pxMembers[TMAN_MAX_GROUP_MEMBERS], *pxMember;
+    struct Group *pxNew;
+    uint32_t count = 0, m, i, k, best;
+    int err;
+    TaskHandle_t xHandle = NULL;
+    
+    if( pcName == NULL || pcMembers == NULL || ( puxStackBuffer == NULL ) != ( pxTaskBuffer == NULL ) )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( g_groupCount >= TMAN_MAX_GROUPS )
+        return TMAN_NO_MEM;
+    
+    err = prvTaskListParse( pcMembers, pxMembers, TMAN_MAX_GROUP_MEMBERS, &count );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    for( m = 0; m < count; m++ )
+    {
+        pxMember = pxMembers[m];
+        if( pxMember->taskPeriod == 0 || pxMember->pxJob == NULL || pxMember->xTaskHandle != NULL ||
+                pxMember->taskPeriod != pxMembers[0]->taskPeriod )
+            return TMAN_INVALID_PARAMETER;
+#if( tmanUSE_SERVERS )
+        if( pxMember->pxServer != NULL )
+            return TMAN_INVALID_PARAMETER;
+#endif
+    }
+    
+    if( count == 0 )
+        return TMAN_INVALID_PARAMETER;
+    
+    /* A member that another one reaches, through tasks out of the group too,
+     * runs after it, ties go to the earlier phase then the higher priority */
+    pxNew = &g_groups[g_groupCount];
+    for( m = 0; m < count; m++ )
+    {
+        best = count;
+        for( i = 0; i < count; i++ )
+        {
+            if( pxMembers[i] == NULL )
+                continue;
+            
+            for( k = 0; k < count; k++ )
+            {
+                if( k != i && pxMembers[k] != NULL && prvPrecedenceReaches( pxMembers[k], pxMembers[i] ) )
+                    break;
+            }
+            if( k < count )
+                continue;
+            
+            if( best == count || pxMembers[i]->taskPhase < pxMembers[best]->taskPhase ||
+                    ( pxMembers[i]->taskPhase == pxMembers[best]->taskPhase &&
+                    pxMembers[i]->fixedPriority > pxMembers[best]->fixedPriority ) )
+                best = i;
+        }
+        
+        pxNew->pxMembers[m] = pxMembers[best];
+        pxMembers[best] = NULL;
+    }
+    pxNew->memberCount = count;
+    
+#if( TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    /* Start at the highest assigned priority, not the one given */
+    uxPriority = tskIDLE_PRIORITY;
+    for( m = 0; m < count; m++ )
+    {
+        if( pxNew->pxMembers[m]->fixedPriority > uxPriority )
+            uxPriority = pxNew->pxMembers[m]->fixedPriority;
+    }
+#endif
+    
+    /* The group task must not run before all its members are bound */
+    vTaskSuspendAll();
+    if( puxStackBuffer != NULL )
+    {
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        xHandle = xTaskCreateStatic( prvGroupTask, pcName, ulStackDepth, pxNew, uxPriority,
+                puxStackBuffer, pxTaskBuffer );
+#endif
+    }
+    else
+    {
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+        if( xTaskCreate( prvGroupTask, pcName, ulStackDepth, pxNew, uxPriority, &xHandle ) != pdPASS )
+            xHandle = NULL;
+#endif
+    }
+    
+    if( xHandle == NULL )
+    {
+        ( void ) xTaskResumeAll();
+        return TMAN_NO_MEM;
+    }
+    
+    pxNew->xTaskHandle = xHandle;
+    for( m = 0; m < count; m++ )
+    {
+        pxNew->pxMembers[m]->pxGroup = pxNew;
+        prvTaskBind( pxNew->pxMembers[m], xHandle );
+    }
+#if( TMAN_PRIORITY_ASSIGNMENT != TMAN_PRIORITY_MANUAL )
+    prvGroupPriority( pxNew );
+#endif
+    g_groupCount++;
+    ( void ) xTaskResumeAll();
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+#if( tmanUSE_SERVERS )
+/* CPU time of the server task so far, wall time without the job statistics */
+static uint32_t prvServerCpuTime( struct Task *pxTask )
+{
+#if( TMAN_USE_JOB_STATS == 1 )
+    uint32_t cpuTime;
+    
+    taskENTER_CRITICAL();
+    cpuTime = pxTask->cpuTime + ( uint32_t ) ( TMAN_TimebaseGet() - pxTask->switchInTime );
+    taskEXIT_CRITICAL();
+    
+    return cpuTime;
+#else
+    ( void ) pxTask;
+    return ( uint32_t ) TMAN_TimebaseGet();
+#endif
+}
+
+/* Refill the budget up to the capacity, an overrun debt is paid first */
+static void prvServerRefill( struct Server *pxServer, uint32_t amount )
+{
+    pxServer->budget += ( int32_t ) amount;
+    if( pxServer->budget > ( int32_t ) pxServer->capacity )
+        pxServer->budget = ( int32_t ) pxServer->capacity;
+}
+
+/* Apply the replenishments of a sporadic server that are due */
+static void prvServerReplenishDue( struct Server *pxServer )
+{
+    uint64_t now = TMAN_TimebaseGet();
+    uint32_t i, due = 0;
+    
+    while( due < pxServer->replenishCount && pxServer->replenishTime[due] <= now )
+    {
+        prvServerRefill( pxServer, pxServer->replenishAmount[due] );
+        due++;
+    }
+    
+    for( i = due; i < pxServer->replenishCount; i++ )
+    {
+        pxServer->replenishTime[i - due] = pxServer->replenishTime[i];
+        pxServer->replenishAmount[i - due] = pxServer->replenishAmount[i];
+    }
+    pxServer->replenishCount -= due;
+}
+
+/* End of an active interval of a sporadic server: what it consumed comes
+ * back one period after the interval started */
+static void prvServerIdle( struct Server *pxServer )
+{
+    uint64_t when = pxServer->activeSince + ( uint64_t ) pxServer->pxTask->taskPeriod * g_tmanTickRateUs *
+            ( TMAN_TIMEBASE_HZ / 1000000UL );
+    uint32_t last;
+    
+    pxServer->active = 0;
+    if( pxServer->consumed == 0 )
+        return;
+    
+    /* A full list merges into its latest entry, which only delays budget */
+    if( pxServer->replenishCount == TMAN_MAX_REPLENISHMENTS )
+    {
+        last = TMAN_MAX_REPLENISHMENTS - 1;
+        pxServer->replenishTime[last] = when;
+        pxServer->replenishAmount[last] += pxServer->consumed;
+    }
+    else
+    {
+        pxServer->replenishTime[pxServer->replenishCount] = when;
+        pxServer->replenishAmount[pxServer->replenishCount] = pxServer->consumed;
+        pxServer->replenishCount++;
+    }
+}
+
+/* Block until the earliest replenishment of a sporadic server */
+static void prvServerSleep( struct Server *pxServer )
+{
+    const uint64_t cyclesPerTick = TMAN_TIMEBASE_HZ / configTICK_RATE_HZ;
+    uint64_t now = TMAN_TimebaseGet();
+    
+    if( pxServer->replenishCount != 0 && pxServer->replenishTime[0] > now )
+        vTaskDelay( ( TickType_t ) ( ( pxServer->replenishTime[0] - now + cyclesPerTick - 1 ) / cyclesPerTick ) );
+}
+
+/* Run one request and charge its CPU time to the budget */
+static void prvServerRun( struct Server *pxServer, const struct ServerRequest *pxRequest )
+{
+    uint32_t start, cost;
+    
+    start = prvServerCpuTime( pxServer->pxTask );
+    pxRequest->pxFunction( pxRequest->pvArg );
+    cost = prvServerCpuTime( pxServer->pxTask ) - start;
+    
+    pxServer->budget -= ( int32_t ) cost;
+    pxServer->consumed += cost;
+    if( pxServer->budget <= 0 )
+        pxServer->stats.budgetExhausted++;
+    
+    taskENTER_CRITICAL();
+    pxServer->stats.requestsServed++;
+#if( TMAN_USE_JOB_STATS == 1 )
+    prvMetricAdd( &pxServer->stats.responseTime, TMAN_TIMEBASE_COUNT() - pxRequest->arrival );
+#endif
+    taskEXIT_CRITICAL();
+}
+
+/* Body of every server task, requests are only started with budget left */
+static void prvServerTask( void *pvParam )
+{
+    struct Server *pxServer = ( struct Server * ) pvParam;
+    struct Task *pxTask = pxServer->pxTask;
+    struct ServerRequest xRequest;
+    uint32_t releases;
+    
+    for(;;)
+    {
+        switch( pxServer->type )
+        {
+            case TMAN_SERVER_POLLING:
+                /* Each release polls the queue once, unused budget is lost */
+                TMAN_TaskWaitPeriodByHandle( pxTask );
+                prvServerRefill( pxServer, pxServer->capacity );
+                while( pxServer->budget > 0 && xQueueReceive( pxServer->xQueue, &xRequest, 0 ) == pdPASS )
+                    prvServerRun( pxServer, &xRequest );
+                if( pxServer->budget > 0 )
+                    pxServer->budget = 0;
+                break;
+                
+            case TMAN_SERVER_DEFERRABLE:
+                /* Budget is kept while idle and refilled by each release */
+                if( pxServer->budget <= 0 )
+                {
+                    prvWaitRelease( pxTask, portMAX_DELAY );
+                    pxServer->releasesSeen = pxTask->jobsReleased;
+                    prvServerRefill( pxServer, pxServer->capacity );
+                    break;
+                }
+                
+                if( xQueueReceive( pxServer->xQueue, &xRequest, portMAX_DELAY ) != pdPASS )
+                    break;
+                if( pxServer->releasesSeen != pxTask->jobsReleased )
+                {
+                    /* Releases that passed while idle refill the budget once */
+                    releases = pxTask->jobsReleased;
+                    prvWaitRelease( pxTask, 0 );
+                    pxServer->releasesSeen = releases;
+                    prvServerRefill( pxServer, pxServer->capacity );
+                }
+                prvServerRun( pxServer, &xRequest );
+                break;
+                
+            default:
+                prvServerReplenishDue( pxServer );
+                if( pxServer->budget <= 0 )
+                {
+                    prvServerSleep( pxServer );
+                    break;
+                }
+                
+                if( xQueueReceive( pxServer->xQueue, &xRequest, portMAX_DELAY ) != pdPASS )
+                    break;
+                prvServerReplenishDue( pxServer );
+                if( !pxServer->active )
+                {
+                    pxServer->active = 1;
+                    pxServer->activeSince = TMAN_TimebaseGet();
+                    pxServer->consumed = 0;
+                }
+                prvServerRun( pxServer, &xRequest );
+                if( pxServer->budget <= 0 || uxQueueMessagesWaiting( pxServer->xQueue ) == 0 )
+                    prvServerIdle( pxServer );
+                break;
+        }
+    }
+}
+
+/* Create a server with a budget of budgetUs every period TMAN ticks, it is
+ * a TMAN task with that period and WCET so the admission test and the
+ * priority assignment account for it */
+int TMAN_ServerCreate( const char *pcName, uint32_t serverType, uint32_t period, uint32_t budgetUs,
+        UBaseType_t uxPriority, TMAN_ServerHandle_t *pxServer )
+{
+    struct Server *pxNew;
+    struct Task *pxTask;
+    int err;
+    
+    if( serverType > TMAN_SERVER_SPORADIC || period == 0 || budgetUs == 0 ||
+            budgetUs > period * g_tmanTickRateUs || pxServer == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( g_serverCount >= TMAN_MAX_SERVERS )
+        return TMAN_NO_MEM;
+    
+    err = TMAN_TaskAdd( pcName, &pxTask );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    pxNew = &g_servers[g_serverCount];
+    memset( pxNew, 0, sizeof( struct Server ) );
+    pxNew->pxTask = pxTask;
+    pxNew->type = serverType;
+    pxNew->capacity = budgetUs * ( TMAN_TIMEBASE_HZ / 1000000UL );
+    pxNew->budget = ( serverType == TMAN_SERVER_POLLING ) ? 0 : ( int32_t ) pxNew->capacity;
+    pxTask->pxServer = pxNew;
+    
+    /* No deadline events, a server job has no completion to check */
+    err = TMAN_TaskSetWcetByHandle( pxTask, budgetUs );
+    if( err == TMAN_SUCCESS )
+        err = TMAN_TaskRegisterAttributesByHandle( pxTask, period, 0, 0, NULL );
+    
+    if( err == TMAN_SUCCESS )
+    {
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+        pxNew->xQueue = xQueueCreateStatic( TMAN_SERVER_QUEUE_LENGTH, sizeof( struct ServerRequest ),
+                pxNew->queueStorage, &pxNew->xQueueBuffer );
+#else
+        pxNew->xQueue = xQueueCreate( TMAN_SERVER_QUEUE_LENGTH, sizeof( struct ServerRequest ) );
+#endif
+        if( pxNew->xQueue == NULL )
+            err = TMAN_NO_MEM;
+    }
+    
+    if( err == TMAN_SUCCESS )
+    {
+#if( TMAN_USE_STATIC_ALLOCATION == 1 )
+        err = TMAN_TaskCreate( pcName, prvServerTask, pxNew, uxPriority, TMAN_SERVER_STACK_SIZE,
+                pxNew->stack, &pxNew->taskBuffer );
+#else
+        err = TMAN_TaskCreate( pcName, prvServerTask, pxNew, uxPriority, TMAN_SERVER_STACK_SIZE, NULL, NULL );
+#endif
+        if( err != TMAN_SUCCESS )
+            vQueueDelete( pxNew->xQueue );
+    }
+    
+    if( err != TMAN_SUCCESS )
+    {
+        /* Hand the record back to the pool */
+        pxTask->pxServer = NULL;
+        ( void ) TMAN_TaskRemoveByHandle( pxTask );
+        return err;
+    }
+    
+    g_serverCount++;
+    *pxServer = pxNew;
+    
+    return TMAN_SUCCESS;
+}
+
+/* Queue an aperiodic request, TMAN_NO_MEM when the server queue is full */
+int TMAN_ServerRequest( TMAN_ServerHandle_t xServer, TMAN_Request_t pxFunction, void *pvArg )
+{
+    struct ServerRequest xRequest;
+    
+    if( xServer == NULL || pxFunction == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    xRequest.pxFunction = pxFunction;
+    xRequest.pvArg = pvArg;
+    xRequest.arrival = TMAN_TIMEBASE_COUNT();
+    
+    if( xQueueSend( xServer->xQueue, &xRequest, 0 ) != pdPASS )
+    {
+        taskENTER_CRITICAL();
+        xServer->stats.requestsDropped++;
+        taskEXIT_CRITICAL();
+        return TMAN_NO_MEM;
+    }
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_ServerRequestFromISR( TMAN_ServerHandle_t xServer, TMAN_Request_t pxFunction, void *pvArg,
+        BaseType_t *pxHigherPriorityTaskWoken )
+{
+    struct ServerRequest xRequest;
+    UBaseType_t uxSavedMask;
+    
+    if( xServer == NULL || pxFunction == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    xRequest.pxFunction = pxFunction;
+    xRequest.pvArg = pvArg;
+    xRequest.arrival = TMAN_TIMEBASE_COUNT();
+    
+    if( xQueueSendFromISR( xServer->xQueue, &xRequest, pxHigherPriorityTaskWoken ) != pdPASS )
+    {
+        uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+        xServer->stats.requestsDropped++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+        return TMAN_NO_MEM;
+    }
+    
+    return TMAN_SUCCESS;
+}
+
+int TMAN_ServerGetStats( TMAN_ServerHandle_t xServer, TMAN_ServerStats_t *pxStats )
+{
+    if( xServer == NULL || pxStats == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    taskENTER_CRITICAL();
+    *pxStats = xServer->stats;
+    taskEXIT_CRITICAL();
+    
+    return TMAN_SUCCESS;
+}
+#else
+int TMAN_ServerCreate( const char *pcName, uint32_t serverType, uint32_t period, uint32_t budgetUs,
+        UBaseType_t uxPriority, TMAN_ServerHandle_t *pxServer )
+{
+    /* Servers need fixed priorities */
+    return TMAN_FAIL;
+}
+
+int TMAN_ServerRequest( TMAN_ServerHandle_t xServer, TMAN_Request_t pxFunction, void *pvArg )
+{
+    return TMAN_FAIL;
+}
+
+int TMAN_ServerRequestFromISR( TMAN_ServerHandle_t xServer, TMAN_Request_t pxFunction, void *pvArg,
+        BaseType_t *pxHigherPriorityTaskWoken )
+{
+    return TMAN_FAIL;
+}
+
+int TMAN_ServerGetStats( TMAN_ServerHandle_t xServer, TMAN_ServerStats_t *pxStats )
+{
+    return TMAN_FAIL;
+}
+#endif
+
+#if( TMAN_MAX_RESOURCES > 0 )
+/* Ceiling of a resource from the current attributes of its users */
+static uint32_t prvResourceCeiling( const struct Resource *pxResource )
+{
+    uint32_t u, ceiling;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    ceiling = UINT32_MAX;
+    for( u = 0; u < pxResource->userCount; u++ )
+    {
+        if( prvRelativeDeadline( pxResource->pxUsers[u] ) < ceiling )
+            ceiling = prvRelativeDeadline( pxResource->pxUsers[u] );
+    }
+#else
+    ceiling = tskIDLE_PRIORITY;
+    for( u = 0; u < pxResource->userCount; u++ )
+    {
+        if( pxResource->pxUsers[u]->fixedPriority > ceiling )
+            ceiling = pxResource->pxUsers[u]->fixedPriority;
+    }
+#endif
+    
+    return ceiling;
+}
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_FIXED )
+/* Run the calling task at its base priority or at the highest ceiling of the
+ * resources it still holds */
+static void prvResourceRestore( struct Task *pxTask )
+{
+    UBaseType_t uxPriority = pxTask->fixedPriority;
+    struct Resource *pxHeld;
+    
+    for( pxHeld = pxTask->pxHeld; pxHeld != NULL; pxHeld = pxHeld->pxNextHeld )
+    {
+        if( pxHeld->ceiling > uxPriority )
+            uxPriority = pxHeld->ceiling;
+    }
+    
+    if( uxTaskPriorityGet( NULL ) != uxPriority )
+        vTaskPrioritySet( NULL, uxPriority );
+}
+#endif
+
+/* Record of the calling task, bound on its first use */
+static struct Task * prvTaskSelf( void )
+{
+    struct Task *pxTask;
+    
+    pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    if( pxTask == NULL )
+    {
+        pxTask = prvTaskFind( pcTaskGetName( NULL ) );
+        if( pxTask != NULL )
+            prvTaskBind( pxTask, xTaskGetCurrentTaskHandle() );
+    }
+    
+    return pxTask;
+}
+#endif
+
+/* Declare a resource shared by a comma separated list of tasks and the
+ * longest critical section any of them runs with it locked. The blocking it
+ * adds to the users' jobs goes through the admission test first */
+int TMAN_ResourceDeclare( const char *pcName, const char *pcUsers, uint32_t csUs,
+        TMAN_ResourceHandle_t *pxResource )
+{
+#if( TMAN_MAX_RESOURCES > 0 )
+    struct Resource *pxNew;
+    int err;
+    
+    if( pcName == NULL || pcUsers == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( g_resourceCount >= TMAN_MAX_RESOURCES )
+        return TMAN_NO_MEM;
+    
+    pxNew = &g_resources[g_resourceCount];
+    pxNew->userCount = 0;
+    
+    err = prvTaskListParse( pcUsers, pxNew->pxUsers, TMAN_MAX_RESOURCE_USERS, &pxNew->userCount );
+    if( err != TMAN_SUCCESS )
+        return err;
+    
+    if( pxNew->userCount == 0 || csUs == 0 )
+        return TMAN_INVALID_PARAMETER;
+    
+    pxNew->pcName = pcName;
+    pxNew->csUs = csUs;
+    pxNew->ceiling = prvResourceCeiling( pxNew );
+    pxNew->pxHolder = NULL;
+    pxNew->pxNextHeld = NULL;
+    
+    g_resourceCount++;
+    prvAdmissionLoad( NULL, 0, 0, 0 );
+    err = prvAdmissionTest();
+    if( err != TMAN_SUCCESS )
+    {
+        g_resourceCount--;
+        return err;
+    }
+    
+    if( pxResource != NULL )
+        *pxResource = pxNew;
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Enter the critical section of a resource: under fixed priorities the task
+ * runs at the resource ceiling until the matching unlock, under EDF the jobs
+ * the ceiling holds back rank after it. The resource is always free for a
+ * declared user, locks nest and unlock in reverse order */
+int TMAN_ResourceLock( TMAN_ResourceHandle_t xResource )
+{
+#if( TMAN_MAX_RESOURCES > 0 )
+    struct Task *pxTask;
+    uint32_t u;
+    
+    if( xResource == NULL || xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+        return TMAN_INVALID_PARAMETER;
+    
+    pxTask = prvTaskSelf();
+    if( pxTask == NULL )
+        return TMAN_INVALID_TASK_NAME;
+    
+    /* Only declared users are accounted for in the ceiling */
+    for( u = 0; u < xResource->userCount; u++ )
+    {
+        if( xResource->pxUsers[u] == pxTask )
+            break;
+    }
+    if( u == xResource->userCount )
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    vTaskSuspendAll();
+    if( xResource->pxHolder != NULL )
+    {
+        ( void ) xTaskResumeAll();
+        return TMAN_FAIL;
+    }
+    
+    xResource->ceiling = prvResourceCeiling( xResource );
+    xResource->pxHolder = pxTask;
+    xResource->pxNextHeld = pxTask->pxHeld;
+    pxTask->pxHeld = xResource;
+    prvEdfReschedule();
+    ( void ) xTaskResumeAll();
+#else
+    /* No other user runs once the task is at the ceiling */
+    xResource->ceiling = prvResourceCeiling( xResource );
+    if( xResource->ceiling > uxTaskPriorityGet( NULL ) )
+        vTaskPrioritySet( NULL, xResource->ceiling );
+    
+    /* Held already, by this task or by one preempted in its critical section */
+    if( xResource->pxHolder != NULL )
+    {
+        prvResourceRestore( pxTask );
+        return TMAN_FAIL;
+    }
+    
+    xResource->pxHolder = pxTask;
+    xResource->pxNextHeld = pxTask->pxHeld;
+    pxTask->pxHeld = xResource;
+#endif
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Leave the critical section of the resource locked last by the calling task */
+int TMAN_ResourceUnlock( TMAN_ResourceHandle_t xResource )
+{
+#if( TMAN_MAX_RESOURCES > 0 )
+    struct Task *pxTask;
+    
+    if( xResource == NULL )
+        return TMAN_INVALID_PARAMETER;
+    
+    pxTask = ( struct Task * ) pvTaskGetThreadLocalStoragePointer( NULL, TMAN_TLS_INDEX );
+    if( pxTask == NULL || pxTask->pxHeld != xResource )
+        return TMAN_INVALID_PARAMETER;
+    
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF )
+    /* Jobs held back by the ceiling may preempt on resume */
+    vTaskSuspendAll();
+    pxTask->pxHeld = xResource->pxNextHeld;
+    xResource->pxHolder = NULL;
+    xResource->pxNextHeld = NULL;
+    prvEdfReschedule();
+    ( void ) xTaskResumeAll();
+#else
+    pxTask->pxHeld = xResource->pxNextHeld;
+    xResource->pxHolder = NULL;
+    xResource->pxNextHeld = NULL;
+    prvResourceRestore( pxTask );
+#endif
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Attach a channel of items of itemSize bytes to the precedence edge
+ * xProducer -> xConsumer. pvSlots holds TMAN_CHANNEL_SLOTS items and belongs
+ * to the channel from then on. Each consumer job reads the item of the
+ * producer job whose completion released it, or the latest one published
+ * before it started once the edge is gone */
+int TMAN_ChannelCreate( TMAN_TaskHandle_t xProducer, TMAN_TaskHandle_t xConsumer, void *pvSlots,
+        uint32_t itemSize, TMAN_ChannelHandle_t *pxChannel )
+{
+#if( TMAN_MAX_CHANNELS > 0 )
+    struct Channel *pxNew;
+    uint32_t k;
+    
+    if( xProducer == NULL || xConsumer == NULL || pvSlots == NULL || itemSize == 0 )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( !prvTaskInUse( xProducer ) || !prvTaskInUse( xConsumer ) )
+        return TMAN_INVALID_TASK_NAME;
+    
+    /* Only an existing edge orders the producer job before the consumer one */
+    for( k = 0; k < xConsumer->predecessorCount; k++ )
+    {
+        if( xConsumer->pxPredecessors[k] == xProducer )
+            break;
+    }
+    if( k == xConsumer->predecessorCount )
+        return TMAN_INVALID_PARAMETER;
+    
+    if( g_channelCount >= TMAN_MAX_CHANNELS )
+        return TMAN_NO_MEM;
+    
+    pxNew = &g_channels[g_channelCount];
+    pxNew->pxProducer = xProducer;
+    pxNew->pxConsumer = xConsumer;
+    pxNew->pucSlots = ( uint8_t * ) pvSlots;
+    pxNew->itemSize = itemSize;
+    pxNew->write = 0;
+    pxNew->ready = tmanCHANNEL_NONE;
+    pxNew->read = tmanCHANNEL_NONE;
+    pxNew->written = 0;
+    
+    taskENTER_CRITICAL();
+    g_channelCount++;
+    taskEXIT_CRITICAL();
+    
+    if( pxChannel != NULL )
+        *pxChannel = pxNew;
+    
+    return TMAN_SUCCESS;
+#else
+    return TMAN_FAIL;
+#endif
+}
+
+/* Slot the running producer job fills, published when the job completes.
+ * NULL when the caller is not the producer or itemSize does not match */
+void *TMAN_ChannelWriteBuffer( TMAN_ChannelHandle_t xChannel, uint32_t itemSize )
+{
+#if( TMAN_MAX_CHANNELS > 0 )
+    if( xChannel == NULL || xChannel->itemSize != itemSize ||
+            xChannel->pxProducer->xTaskHandle != xTaskGetCurrentTaskHandle() )
+        return NULL;
+    
+    xChannel->written = 1;
+    
+    return &xChannel->pucSlots[( uint32_t ) xChannel->write * itemSize];
+#else
+    return NULL;
+#endif
+}
+
+/* Slot the running consumer job reads, valid until it calls
+ * TMAN_TaskWaitPeriod. NULL before the producer published anything, when
+ * the caller is not the consumer or itemSize does not match */
+const void *TMAN_ChannelReadBuffer( TMAN_ChannelHandle_t xChannel, uint32_t itemSize )
+{
+#if( TMAN_MAX_CHANNELS > 0 )
+    if( xChannel == NULL || xChannel->itemSize != itemSize || xChannel->read == tmanCHANNEL_NONE ||
+            xChannel->pxConsumer->xTaskHandle != xTaskGetCurrentTaskHandle() )
+        return NULL;
+    
+    return &xChannel->pucSlots[( uint32_t ) xChannel->read * itemSize];
+#else
+    return NULL;
+#endif
+}
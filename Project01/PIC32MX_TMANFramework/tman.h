@@ -26,18 +26,443 @@
 #define TMAN_INVALID_TASK_NAME                         -4
 #define TMAN_DIFFERENT_TASKS_FRAMEWORK_INITIALIZED     -5
 #define TMAN_TICK_RATE_NOT_MULTIPLE_FREERTOS_TICK      -6
+#define TMAN_HYPERPERIOD_TOO_LONG                      -7
+#define TMAN_PRECEDENCE_CYCLE                          -8
+#define TMAN_NOT_SCHEDULABLE                           -9
+#define TMAN_RELEASE_TOO_EARLY                         -10
+#define TMAN_TASK_IN_USE                               -11
 /* Configuration variables */
-#define TMAN_MAX_TASKS                                  ( 30 )
+/* Size of the static pool of task records, TMAN_TaskRemove frees a record
+ * for the next TMAN_TaskAdd */
+#ifndef TMAN_MAX_TASKS
+    #define TMAN_MAX_TASKS                              ( 30 )
+#endif
 #define TMAN_PRIORITY_REGULATOR_TASK                    ( ( ( UBaseType_t ) configMAX_PRIORITIES ) - 1 )
+/* Release structure built by TMAN_Start for the regulator:
+ * - TMAN_RELEASE_SCAN checks every task on every TMAN tick
+ * - TMAN_RELEASE_TABLE walks one slot of a precomputed hyperperiod table per TMAN tick
+ * - TMAN_RELEASE_QUEUE keeps a min-heap of next releases and sleeps until the earliest one */
+#define TMAN_RELEASE_SCAN                               ( 0 )
+#define TMAN_RELEASE_TABLE                              ( 1 )
+#define TMAN_RELEASE_QUEUE                              ( 2 )
+#ifndef TMAN_RELEASE_MODE
+    #define TMAN_RELEASE_MODE                           TMAN_RELEASE_QUEUE
+#endif
+/* Pending deadline events, TMAN_Start needs ceil(deadline / period) per task */
+#define TMAN_MAX_DEADLINES                              ( 2 * TMAN_MAX_TASKS )
+/* Release table limits: hyperperiod in TMAN ticks and releases per hyperperiod */
+#define TMAN_MAX_HYPERPERIOD                            ( 64 )
+#define TMAN_MAX_RELEASES                               ( 256 )
+/* Release tasks with direct-to-task notifications instead of two binary
+ * semaphores per task */
+#ifndef TMAN_USE_TASK_NOTIFICATIONS
+    #define TMAN_USE_TASK_NOTIFICATIONS                 ( 1 )
+#endif
+/* Notification slots used by TMAN, slot 0 stays free for the application */
+#define TMAN_NOTIFY_INDEX_RELEASE                       ( 1 )
+#define TMAN_NOTIFY_INDEX_PRECEDENCE                    ( 2 )
+/* Precedence DAG limits: edges into and out of a single task */
+#define TMAN_MAX_PREDECESSORS                           ( 4 )
+#define TMAN_MAX_SUCCESSORS                             ( 4 )
+/* Thread local storage slot holding the TMAN record of each FreeRTOS task */
+#define TMAN_TLS_INDEX                                  ( 0 )
+/* Source of the TMAN tick:
+ * - TMAN_TIME_SOURCE_TASK wakes the regulator task, ticks are FreeRTOS tick multiples
+ * - TMAN_TIME_SOURCE_TICK_HOOK releases jobs from vApplicationTickHook in main.c
+ * - TMAN_TIME_SOURCE_TIMER releases jobs from the Timer2 interrupt, ticks in microseconds */
+#define TMAN_TIME_SOURCE_TASK                           ( 0 )
+#define TMAN_TIME_SOURCE_TICK_HOOK                      ( 1 )
+#define TMAN_TIME_SOURCE_TIMER                          ( 2 )
+#ifndef TMAN_TIME_SOURCE
+    #define TMAN_TIME_SOURCE                            TMAN_TIME_SOURCE_TASK
+#endif
+/* Band of priorities TMAN gives to the tasks when it assigns them itself */
+#define TMAN_TASK_PRIORITY_HIGH                         ( TMAN_PRIORITY_REGULATOR_TASK - 1 )
+#define TMAN_TASK_PRIORITY_LOW                          ( tskIDLE_PRIORITY + 1 )
+/* Scheduling of the TMAN tasks:
+ * - TMAN_SCHED_FIXED runs the tasks at fixed priorities, see TMAN_PRIORITY_ASSIGNMENT
+ * - TMAN_SCHED_EDF ranks the released jobs by absolute deadline and maps the
+ *   ranks onto the task priority band */
+#define TMAN_SCHED_FIXED                                ( 0 )
+#define TMAN_SCHED_EDF                                  ( 1 )
+#ifndef TMAN_SCHED_POLICY
+    #define TMAN_SCHED_POLICY                           TMAN_SCHED_FIXED
+#endif
+/* Fixed priorities:
+ * - TMAN_PRIORITY_MANUAL keeps the priorities the application gave to xTaskCreate
+ * - TMAN_PRIORITY_RM orders the tasks by period, TMAN_PRIORITY_DM by relative
+ *   deadline, tasks with equal keys share a priority of the band */
+#define TMAN_PRIORITY_MANUAL                            ( 0 )
+#define TMAN_PRIORITY_RM                                ( 1 )
+#define TMAN_PRIORITY_DM                                ( 2 )
+#ifndef TMAN_PRIORITY_ASSIGNMENT
+    #define TMAN_PRIORITY_ASSIGNMENT                    TMAN_PRIORITY_MANUAL
+#endif
+/* Partitioned placement on a multicore kernel, one with configNUM_CORES
+ * above 1 and configUSE_CORE_AFFINITY set: every task is pinned to one core
+ * and the admission test runs per core. The admission test places the tasks
+ * not placed yet in decreasing utilization, TMAN_Start places the whole set
+ * again. Tasks sharing a resource or a rate group move together:
+ * - TMAN_PARTITION_FIRST_FIT takes the lowest core where the task passes the
+ *   admission test, the set is packed onto as few cores as it fits
+ * - TMAN_PARTITION_WORST_FIT the least utilized one, the load is spread */
+#define TMAN_PARTITION_FIRST_FIT                        ( 0 )
+#define TMAN_PARTITION_WORST_FIT                        ( 1 )
+#ifndef TMAN_PARTITION
+    #define TMAN_PARTITION                              TMAN_PARTITION_FIRST_FIT
+#endif
+#if( configNUM_CORES > 1 && configUSE_CORE_AFFINITY == 1 )
+    #define TMAN_NUM_CORES                              ( configNUM_CORES )
+#else
+    #define TMAN_NUM_CORES                              ( 1 )
+#endif
+/* Core of a task not placed yet, it may run on any core */
+#define TMAN_CORE_ANY                                   ( 0xFFFFFFFFUL )
+/* Per-job release jitter, start latency, execution and response times */
+#ifndef TMAN_USE_JOB_STATS
+    #define TMAN_USE_JOB_STATS                          ( 1 )
+#endif
+/* Free running timebase of the job statistics, the CP0 Count register
+ * increments at half the CPU clock */
+#ifndef TMAN_TIMEBASE_COUNT
+    #define TMAN_TIMEBASE_COUNT()                       _CP0_GET_COUNT()
+#endif
+#ifndef TMAN_TIMEBASE_HZ
+    #define TMAN_TIMEBASE_HZ                            ( configCPU_CLOCK_HZ / 2UL )
+#endif
+#define TMAN_TIMEBASE_TO_US( x )                        ( ( x ) / ( TMAN_TIMEBASE_HZ / 1000000UL ) )
+/* Log2 histogram of every metric: bucket 0 holds values below
+ * TMAN_STATS_BUCKET_US, each next bucket is twice as wide, the last one is open */
+#define TMAN_STATS_BUCKETS                              ( 16 )
+#ifndef TMAN_STATS_BUCKET_US
+    #define TMAN_STATS_BUCKET_US                        ( 8 )
+#endif
+/* Create the TMAN tasks and semaphores in static storage instead of the
+ * FreeRTOS heap, the default whenever the kernel supports it */
+#ifndef TMAN_USE_STATIC_ALLOCATION
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        #define TMAN_USE_STATIC_ALLOCATION              ( 1 )
+    #else
+        #define TMAN_USE_STATIC_ALLOCATION              ( 0 )
+    #endif
+#endif
+/* Sporadic tasks, what TMAN_TaskReleaseFromISR does with a release that
+ * comes before the minimum inter-arrival time elapsed:
+ * - TMAN_SPORADIC_DROP drops it
+ * - TMAN_SPORADIC_DEFER releases it once the time elapsed, at the TMAN tick
+ *   resolution, and drops further early releases while one is deferred */
+#define TMAN_SPORADIC_DROP                              ( 0 )
+#define TMAN_SPORADIC_DEFER                             ( 1 )
+/* Release of a job while an earlier one of the task has not completed:
+ * - TMAN_OVERRUN_QUEUE queues the activation, up to the backlog bound given
+ *   to TMAN_TaskSetOverrunPolicy, the queued jobs start back to back
+ * - TMAN_OVERRUN_SKIP skips the job, the task waits for the next release
+ * - TMAN_OVERRUN_ABORT queues one activation and raises the abort request
+ *   polled with TMAN_TaskAbortRequested
+ * Releases beyond the backlog and skipped jobs are counted in jobsSkipped */
+#define TMAN_OVERRUN_QUEUE                              ( 0 )
+#define TMAN_OVERRUN_SKIP                               ( 1 )
+#define TMAN_OVERRUN_ABORT                              ( 2 )
+/* Backlog of the tasks that keep the default TMAN_OVERRUN_QUEUE policy */
+#ifndef TMAN_DEFAULT_BACKLOG
+    #define TMAN_DEFAULT_BACKLOG                        ( 1 )
+#endif
+/* Mixed criticality: a TMAN_CRIT_HI task declares an optimistic and a
+ * pessimistic budget. When one of its jobs runs past the optimistic budget
+ * the system enters the high criticality mode, the TMAN_CRIT_LO tasks are
+ * then released once every TMAN_MC_STRETCH releases, never when it is 0, and
+ * their jobs in progress see an abort request. The low criticality mode comes
+ * back at the first TMAN tick where every released job has completed */
+#define TMAN_CRIT_LO                                    ( 0 )
+#define TMAN_CRIT_HI                                    ( 1 )
+#ifndef TMAN_MC_STRETCH
+    #define TMAN_MC_STRETCH                             ( 0 )
+#endif
+/* Modes: task sets saved with TMAN_ModeSave, TMAN_ModeChange switches
+ * between them at a safe point:
+ * - TMAN_MODE_AT_HYPERPERIOD at the next hyperperiod boundary of the current mode
+ * - TMAN_MODE_WHEN_IDLE once the tasks the change affects have no job in progress */
+#ifndef TMAN_MAX_MODES
+    #define TMAN_MAX_MODES                              ( 2 )
+#endif
+#define TMAN_MODE_NONE                                  ( 0xFFFFFFFFUL )
+#define TMAN_MODE_AT_HYPERPERIOD                        ( 0 )
+#define TMAN_MODE_WHEN_IDLE                             ( 1 )
+/* Aperiodic servers, fixed priority scheduling only:
+ * - TMAN_SERVER_POLLING serves the requests queued at each release, the
+ *   budget left when the queue is empty is lost until the next release
+ * - TMAN_SERVER_DEFERRABLE keeps its budget for requests arriving later in
+ *   the period and refills it at every release
+ * - TMAN_SERVER_SPORADIC refills what it consumed one period after it
+ *   became active, which interferes like a periodic task of the same budget */
+#define TMAN_SERVER_POLLING                             ( 0 )
+#define TMAN_SERVER_DEFERRABLE                          ( 1 )
+#define TMAN_SERVER_SPORADIC                            ( 2 )
+#ifndef TMAN_MAX_SERVERS
+    #define TMAN_MAX_SERVERS                            ( 2 )
+#endif
+/* Requests waiting in a server and pending replenishments of a sporadic server */
+#ifndef TMAN_SERVER_QUEUE_LENGTH
+    #define TMAN_SERVER_QUEUE_LENGTH                    ( 8 )
+#endif
+#define TMAN_MAX_REPLENISHMENTS                         ( 4 )
+/* Requests run on the stack of the server task */
+#ifndef TMAN_SERVER_STACK_SIZE
+    #define TMAN_SERVER_STACK_SIZE                      ( 2 * configMINIMAL_STACK_SIZE )
+#endif
+/* Rate groups, fixed priority scheduling only: one FreeRTOS task runs the
+ * job functions of periodic tasks of equal period back to back, so they
+ * share a stack and a wake up per release and keep their own accounting */
+#ifndef TMAN_MAX_GROUPS
+    #define TMAN_MAX_GROUPS                             ( 4 )
+#endif
+#define TMAN_MAX_GROUP_MEMBERS                          ( 4 )
+/* Shared resources: TMAN_ResourceLock runs the critical section at the
+ * ceiling of the resource, the highest priority of the tasks declared to use
+ * it, so a job is blocked at most once, by a single critical section of a
+ * lower priority task, before it starts. Under EDF the Stack Resource Policy
+ * holds back the jobs whose relative deadline is not shorter than the
+ * ceilings of the locked resources. Critical sections must not block */
+#ifndef TMAN_MAX_RESOURCES
+    #define TMAN_MAX_RESOURCES                          ( 4 )
+#endif
+#define TMAN_MAX_RESOURCE_USERS                         ( 4 )
+/* Data channels on precedence edges: a producer job fills a slot in place
+ * and the consumer job its completion releases reads that slot in place.
+ * With three slots the one being filled is never the one being read nor the
+ * one waiting for the consumer, so no job copies data or waits for a lock */
+#ifndef TMAN_MAX_CHANNELS
+    #define TMAN_MAX_CHANNELS                           ( 4 )
+#endif
+#define TMAN_CHANNEL_SLOTS                              ( 3 )
+/* Statistics reporter created by TMAN_Init when stats is 1: it runs at the
+ * idle priority and prints a summary every TMAN_REPORT_PERIOD TMAN ticks.
+ * With the tick hook or Timer2 time source it is also created for the
+ * default deadline callback, whose reports it prints at the same period
+ * instead of the interrupt. Callbacks given to TMAN_Init or
+ * TMAN_SetDeadlineMissCallback run in the interrupt and must not block */
+#ifndef TMAN_REPORT_PERIOD
+    #define TMAN_REPORT_PERIOD                          ( 25 )
+#endif
+#define TMAN_PRIORITY_REPORTER_TASK                     ( tskIDLE_PRIORITY )
+#define TMAN_REPORTER_STACK_SIZE                        ( 2 * configMINIMAL_STACK_SIZE )
+/* Binary job event trace kept in a RAM ring, drained by TMAN_TraceRead or
+ * TMAN_TraceDump and decoded on the host by Project01/TMANTrace */
+#ifndef TMAN_USE_TRACE
+    #define TMAN_USE_TRACE                              ( 1 )
+#endif
+/* Records in the ring, a power of two, the oldest ones are overwritten */
+#ifndef TMAN_TRACE_LENGTH
+    #define TMAN_TRACE_LENGTH                           ( 256 )
+#endif
+/* Also trace every context switch of a TMAN task, shows preemptions in the chart */
+#ifndef TMAN_TRACE_SWITCHES
+    #define TMAN_TRACE_SWITCHES                         ( 0 )
+#endif
+/* Trace events, the argument of each is listed after it */
+#define TMAN_TRACE_RELEASE                              ( 1 )   /* job number */
+#define TMAN_TRACE_START                                ( 2 )   /* job number */
+#define TMAN_TRACE_PRECEDENCE_WAIT                      ( 3 )   /* predecessors done, bit mask */
+#define TMAN_TRACE_COMPLETE                             ( 4 )   /* job number */
+#define TMAN_TRACE_MISS                                 ( 5 )   /* lateness in TMAN ticks */
+#define TMAN_TRACE_SWITCH_IN                            ( 6 )   /* 0 */
+#define TMAN_TRACE_SWITCH_OUT                           ( 7 )   /* 0 */
+#define TMAN_TRACE_OVERRUN                              ( 8 )   /* activations queued, 0 when skipped */
+#define TMAN_TRACE_CRITICALITY                          ( 9 )   /* criticality entered, by the task that raised it */
+
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS <= TMAN_TLS_INDEX )
+    #error configNUM_THREAD_LOCAL_STORAGE_POINTERS must reserve a slot for TMAN_TLS_INDEX
+#endif
+
+#if( TMAN_USE_TASK_NOTIFICATIONS == 1 && configTASK_NOTIFICATION_ARRAY_ENTRIES <= TMAN_NOTIFY_INDEX_PRECEDENCE )
+    #error configTASK_NOTIFICATION_ARRAY_ENTRIES must provide the TMAN notification slots
+#endif
+
+#if( TMAN_USE_STATIC_ALLOCATION == 1 && configSUPPORT_STATIC_ALLOCATION != 1 )
+    #error TMAN_USE_STATIC_ALLOCATION needs configSUPPORT_STATIC_ALLOCATION set to 1
+#endif
+
+#if( TMAN_USE_STATIC_ALLOCATION == 0 && configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+    #error Without configSUPPORT_DYNAMIC_ALLOCATION set TMAN_USE_STATIC_ALLOCATION to 1
+#endif
+
+#if( TMAN_USE_TRACE == 1 && ( TMAN_TRACE_LENGTH & ( TMAN_TRACE_LENGTH - 1 ) ) != 0 )
+    #error TMAN_TRACE_LENGTH must be a power of two
+#endif
+
+#if( TMAN_NUM_CORES > 32 )
+    #error TMAN_NUM_CORES must fit the core affinity mask
+#endif
+
+#if( TMAN_MAX_PREDECESSORS > 31 )
+    #error TMAN_MAX_PREDECESSORS must fit the join bit mask
+#endif
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF && TMAN_TIME_SOURCE != TMAN_TIME_SOURCE_TASK )
+    #error TMAN_SCHED_EDF sets priorities from the regulator task, use TMAN_TIME_SOURCE_TASK
+#endif
+
+#if( TMAN_SCHED_POLICY == TMAN_SCHED_EDF && configMAX_PRIORITIES < 4 )
+    #error TMAN_SCHED_EDF needs at least two priorities below the regulator task
+#endif
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TICK_HOOK && configUSE_TICK_HOOK != 1 )
+    #error TMAN_TIME_SOURCE_TICK_HOOK needs configUSE_TICK_HOOK set to 1
+#endif
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TASK && TMAN_RELEASE_MODE == TMAN_RELEASE_QUEUE && INCLUDE_xTaskAbortDelay != 1 )
+    #error TMAN_RELEASE_QUEUE wakes the regulator task early, set INCLUDE_xTaskAbortDelay to 1
+#endif
+
+/* Opaque handle of a task added to the framework */
+struct Task;
+typedef struct Task * TMAN_TaskHandle_t;
+
+/* No predecessor in a task set entry */
+#define TMAN_TASKSET_NONE           ( 0xFF )
+
+/* One task of a set described at compile time, see tmantaskset.h
+ * - predecessors: indexes of earlier entries of the set, predecessorCount
+ *   of them, and pcPrecedence their names as TMAN_TaskRegisterAttributes
+ *   takes them
+ * - pxTaskCode: NULL to leave the FreeRTOS task to TMAN_TaskCreate or a
+ *   rate group, the fields after it are only used when it is set */
+typedef struct {
+    const char *pcName;
+    uint32_t period;
+    uint32_t phase;
+    uint32_t deadline;
+    uint32_t wcetUs;
+    uint8_t predecessors[TMAN_MAX_PREDECESSORS];
+    uint8_t predecessorCount;
+    const char *pcPrecedence;
+    TaskFunction_t pxTaskCode;
+    void *pvParameters;
+    UBaseType_t uxPriority;
+    uint32_t ulStackDepth;
+    StackType_t *puxStackBuffer;
+    StaticTask_t *pxTaskBuffer;
+} TMAN_TaskSetEntry_t;
+
+/* Distribution of a per-job metric, values in timebase cycles */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+    uint32_t histogram[TMAN_STATS_BUCKETS];
+} TMAN_Metric_t;
+
+/* Per-job statistics of a task:
+ * - releaseJitter: release instant minus the ideal TMAN tick instant, for a
+ *   sporadic job minus the instant its release was allowed
+ * - startLatency: release to the job passing TMAN_TaskWaitPeriod
+ * - executionTime: CPU time of the job, preemptions excluded
+ * - responseTime: release to the job calling TMAN_TaskWaitPeriod again */
+typedef struct {
+    TMAN_Metric_t releaseJitter;
+    TMAN_Metric_t startLatency;
+    TMAN_Metric_t executionTime;
+    TMAN_Metric_t responseTime;
+} TMAN_JobStats_t;
+
+/* Opaque handle of an aperiodic server and the requests it serves */
+struct Server;
+typedef struct Server * TMAN_ServerHandle_t;
+typedef void ( *TMAN_Request_t )( void *pvArg );
+
+/* Job function of a task run by a rate group, one call per job */
+typedef void ( *TMAN_Job_t )( void *pvArg );
+
+/* Opaque handle of a shared resource */
+struct Resource;
+typedef struct Resource * TMAN_ResourceHandle_t;
+
+/* Opaque handle of a data channel, typed access to its slots, NULL when the
+ * type does not match the item size of the channel */
+struct Channel;
+typedef struct Channel * TMAN_ChannelHandle_t;
+#define TMAN_CHANNEL_WRITE( xChannel, type )            ( ( type * ) TMAN_ChannelWriteBuffer( ( xChannel ), sizeof( type ) ) )
+#define TMAN_CHANNEL_READ( xChannel, type )             ( ( const type * ) TMAN_ChannelReadBuffer( ( xChannel ), sizeof( type ) ) )
+
+/* Counters of a server, response times from request to completion */
+typedef struct {
+    uint32_t requestsServed;
+    uint32_t requestsDropped;
+    uint32_t budgetExhausted;
+    TMAN_Metric_t responseTime;
+} TMAN_ServerStats_t;
+
+/* Counters of a task in a statistics snapshot, response times in timebase
+ * cycles, responseCount stays 0 without TMAN_USE_JOB_STATS. core is 0 on a
+ * single core kernel */
+typedef struct {
+    const char *pcName;
+    uint32_t core;
+    uint32_t activations;
+    uint32_t jobsReleased;
+    uint32_t jobsCompleted;
+    uint32_t deadlineMisses;
+    uint32_t releasesDropped;
+    uint32_t releasesDeferred;
+    uint32_t overruns;
+    uint32_t jobsSkipped;
+    uint32_t backlogMax;
+    uint32_t responseMin;
+    uint32_t responseMax;
+    uint64_t responseSum;
+    uint32_t responseCount;
+} TMAN_TaskStats_t;
+
+/* Statistics of the whole framework taken at a single instant */
+typedef struct {
+    uint32_t tick;
+    uint32_t criticality;
+    uint32_t criticalitySwitches;
+    uint32_t taskCount;
+    TMAN_TaskStats_t tasks[TMAN_MAX_TASKS];
+} TMAN_Stats_t;
+
+/* Trace record, timestamp is the low word of the timebase */
+typedef struct {
+    uint32_t timestamp;
+    uint8_t event;
+    uint8_t task;
+    uint16_t arg;
+} TMAN_TraceRecord_t;
 
 /* Define public methods */
 int TMAN_Init( uint32_t tmanTickRateMs,
                                     uint32_t stats, 
                                     void (*ptr)()
                                     );
+int TMAN_InitUs( uint32_t tmanTickRateUs,
+                                    uint32_t stats, 
+                                    void (*ptr)()
+                                    );
+int TMAN_Start( void
+                                    );
 void TMAN_Close(
                                     );
-int TMAN_TaskAdd( const char *pcName
+int TMAN_TaskAdd( const char *pcName,
+                                    TMAN_TaskHandle_t *pxTaskHandle
+                                    );
+int TMAN_TaskCreate( const char *pcName,
+                                    TaskFunction_t pxTaskCode,
+                                    void *pvParameters,
+                                    UBaseType_t uxPriority,
+                                    uint32_t ulStackDepth,
+                                    StackType_t *puxStackBuffer,
+                                    StaticTask_t *pxTaskBuffer
+                                    );
+int TMAN_TaskSetLoad( const TMAN_TaskSetEntry_t *pxSet,
+                                    uint32_t count
+                                    );
+int TMAN_TaskRemove( const char *pcName
+                                    );
+int TMAN_TaskRemoveByHandle( TMAN_TaskHandle_t xTask
+                                    );
+TMAN_TaskHandle_t TMAN_TaskGetHandle( const char *pcName
                                     );
 int TMAN_TaskRegisterAttributes( const char *pcName,
                                     uint32_t taskPeriod, 
@@ -45,12 +470,159 @@ int TMAN_TaskRegisterAttributes( const char *pcName,
                                     uint32_t taskDeadline, 
                                     const char *taskPrecedenceConstrains
                                     );
+int TMAN_TaskRegisterAttributesByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t taskPeriod, 
+                                    uint32_t taskPhase,
+                                    uint32_t taskDeadline, 
+                                    TMAN_TaskHandle_t xPrecedence
+                                    );
+int TMAN_TaskSetWcet( const char *pcName,
+                                    uint32_t wcetUs
+                                    );
+int TMAN_TaskSetWcetByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t wcetUs
+                                    );
+int TMAN_TaskAddPrecedence( TMAN_TaskHandle_t xTask,
+                                    TMAN_TaskHandle_t xPredecessor
+                                    );
+int TMAN_TaskSetSporadic( const char *pcName,
+                                    uint32_t minInterArrival,
+                                    uint32_t policy
+                                    );
+int TMAN_TaskSetSporadicByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t minInterArrival,
+                                    uint32_t policy
+                                    );
+int TMAN_TaskReleaseFromISR( TMAN_TaskHandle_t xTask,
+                                    BaseType_t *pxHigherPriorityTaskWoken
+                                    );
+int TMAN_TaskSetOverrunPolicy( const char *pcName,
+                                    uint32_t policy,
+                                    uint32_t maxBacklog
+                                    );
+int TMAN_TaskSetOverrunPolicyByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t policy,
+                                    uint32_t maxBacklog
+                                    );
+uint32_t TMAN_TaskAbortRequested( TMAN_TaskHandle_t xTask
+                                    );
+int TMAN_TaskSetCriticality( const char *pcName,
+                                    uint32_t criticality,
+                                    uint32_t budgetLoUs,
+                                    uint32_t budgetHiUs
+                                    );
+int TMAN_TaskSetCriticalityByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t criticality,
+                                    uint32_t budgetLoUs,
+                                    uint32_t budgetHiUs
+                                    );
+uint32_t TMAN_CriticalityGet( void
+                                    );
+int TMAN_TaskSetActive( const char *pcName,
+                                    uint32_t active
+                                    );
+int TMAN_TaskSetActiveByHandle( TMAN_TaskHandle_t xTask,
+                                    uint32_t active
+                                    );
+int TMAN_ModeSave( uint32_t mode
+                                    );
+int TMAN_ModeChange( uint32_t mode,
+                                    uint32_t when
+                                    );
+uint32_t TMAN_ModeGet( void
+                                    );
+int TMAN_TaskGetTopologicalOrder( TMAN_TaskHandle_t *pxOrder,
+                                    uint32_t maxTasks
+                                    );
+int TMAN_ServerCreate( const char *pcName,
+                                    uint32_t serverType,
+                                    uint32_t period,
+                                    uint32_t budgetUs,
+                                    UBaseType_t uxPriority,
+                                    TMAN_ServerHandle_t *pxServer
+                                    );
+int TMAN_ServerRequest( TMAN_ServerHandle_t xServer,
+                                    TMAN_Request_t pxFunction,
+                                    void *pvArg
+                                    );
+int TMAN_ServerRequestFromISR( TMAN_ServerHandle_t xServer,
+                                    TMAN_Request_t pxFunction,
+                                    void *pvArg,
+                                    BaseType_t *pxHigherPriorityTaskWoken
+                                    );
+int TMAN_ServerGetStats( TMAN_ServerHandle_t xServer,
+                                    TMAN_ServerStats_t *pxStats
+                                    );
+int TMAN_ResourceDeclare( const char *pcName,
+                                    const char *pcUsers,
+                                    uint32_t csUs,
+                                    TMAN_ResourceHandle_t *pxResource
+                                    );
+int TMAN_ResourceLock( TMAN_ResourceHandle_t xResource
+                                    );
+int TMAN_ResourceUnlock( TMAN_ResourceHandle_t xResource
+                                    );
+int TMAN_ChannelCreate( TMAN_TaskHandle_t xProducer,
+                                    TMAN_TaskHandle_t xConsumer,
+                                    void *pvSlots,
+                                    uint32_t itemSize,
+                                    TMAN_ChannelHandle_t *pxChannel
+                                    );
+void *TMAN_ChannelWriteBuffer( TMAN_ChannelHandle_t xChannel,
+                                    uint32_t itemSize
+                                    );
+const void *TMAN_ChannelReadBuffer( TMAN_ChannelHandle_t xChannel,
+                                    uint32_t itemSize
+                                    );
+int TMAN_TaskSetJob( const char *pcName,
+                                    TMAN_Job_t pxJob,
+                                    void *pvArg
+                                    );
+int TMAN_GroupCreate( const char *pcName,
+                                    const char *pcMembers,
+                                    UBaseType_t uxPriority,
+                                    uint32_t ulStackDepth,
+                                    StackType_t *puxStackBuffer,
+                                    StaticTask_t *pxTaskBuffer
+                                    );
 int TMAN_TaskWaitPeriod( char *pcName
                                     );
+int TMAN_TaskWaitPeriodByHandle( TMAN_TaskHandle_t xTask
+                                    );
+int TMAN_TaskWaitPeriodSelf( void
+                                    );
 void TMAN_TaskStats( const char * name
                                     );
+void TMAN_TaskStatsByHandle( TMAN_TaskHandle_t xTask
+                                    );
+int TMAN_GetStats( TMAN_Stats_t *pxStats
+                                    );
+int TMAN_TaskGetStats( TMAN_TaskHandle_t xTask,
+                                    TMAN_TaskStats_t *pxStats
+                                    );
+int TMAN_TaskGetJobStats( TMAN_TaskHandle_t xTask,
+                                    TMAN_JobStats_t *pxStats
+                                    );
+int TMAN_TaskResetJobStats( TMAN_TaskHandle_t xTask
+                                    );
+uint32_t TMAN_TraceRead( TMAN_TraceRecord_t *pxRecords,
+                                    uint32_t maxRecords,
+                                    uint32_t *pLost
+                                    );
+void TMAN_TraceDump( void
+                                    );
+uint64_t TMAN_TimebaseGet( void
+                                    );
+void TMAN_TraceSwitchedIn( void
+                                    );
+void TMAN_TraceSwitchedOut( void
+                                    );
+void TMAN_SetDeadlineMissCallback( void (*ptr)( const char *pcName, uint32_t lateness )
+                                    );
 void TMAN_TickHandler( void *pvParam
                                     );
+void TMAN_TickFromISR( void
+                                    );
 void TMAN_DeadlineCallback(const char * name
                                     );
 
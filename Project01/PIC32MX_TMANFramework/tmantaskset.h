@@ -0,0 +1,157 @@
+/*
+ * authors:
+ * Martim Neves, mec:88904
+ * Daniel Vala Correia, mec:90480
+ *
+ *
+ * Environment:
+ * - MPLAB X IDE v5.50
+ * - XC32 V2.50
+ * - FreeRTOS V202107.00
+ *
+ */
+
+/*
+ * Task set described at compile time
+ * - The application lists its tasks once, in an X macro, and
+ *   TMAN_TASKSET_DEFINE generates the task table, the stacks and control
+ *   blocks of the tasks and the build time checks of the set
+ * - TMAN_TASKSET_LOAD adds the whole set to the framework by index, with
+ *   no name lookup and no parsing of precedence strings
+ *
+ * Each task is one X( name, period, phase, deadline, wcetUs, predecessor,
+ * priority, code, stack ) line:
+ * - name: bare identifier, also the task name and the parameter of its code
+ * - period, phase, deadline: in TMAN ticks as in TMAN_TaskRegisterAttributes,
+ *   period 0 for a task released by its predecessor only
+ * - wcetUs: budget in microseconds as in TMAN_TaskSetWcet, 0 for none
+ * - predecessor: name of an earlier task of the set, NONE, or for a join
+ *   TMAN_PREDS( a, b ) with up to TMAN_MAX_PREDECESSORS earlier tasks (8 at
+ *   most), all of which complete before the task is released
+ * - priority, code, stack: FreeRTOS task of the entry, code NONE to create
+ *   it later with TMAN_TaskCreate or TMAN_GroupCreate, such an entry gets no
+ *   stack or control block
+ *
+ * The build fails when:
+ * - a predecessor is not a task of the set, or not declared before the
+ *   task, so the precedence graph can not hold a cycle
+ * - two tasks share a name
+ * - a task has neither a period nor a predecessor
+ * - a task has more than TMAN_MAX_PREDECESSORS predecessors
+ * - a priority is not below the regulator task
+ * - the set does not fit TMAN_MAX_TASKS
+ * - the utilization of the periodic tasks with a WCET is above the number
+ *   of cores, TMAN_NUM_CORES, each term rounded up. Tasks released by a
+ *   predecessor have no period of their own, they and the placement on the
+ *   cores are left to the admission test of TMAN_TaskSetLoad
+ *
+ * One set per file, the identifiers are file scope.
+ */
+
+#ifndef TMANTASKSET_H
+#define	TMANTASKSET_H
+
+#include "tman.h"
+
+/* Fixed point scale of the utilization check, a multiple of the periods
+ * 1 to 16 so the usual terms are exact */
+#define TMAN_TASKSET_SCALE          ( 720720ULL )
+
+/* Predecessors of a join, in the predecessor column */
+#define TMAN_PREDS( ... )           ( __VA_ARGS__ )
+
+/* Index of the predecessor NONE */
+enum { tmanID_NONE = TMAN_TASKSET_NONE };
+
+/* Preprocessor helpers of the predecessor lists */
+#define tmanCAT( a, b )             tmanCAT_I( a, b )
+#define tmanCAT_I( a, b )           a##b
+#define tmanCALL( f, args )         f args
+#define tmanUNPAREN( ... )          __VA_ARGS__
+#define tmanARG1( a, ... )          a
+#define tmanARG2( a, b, ... )       b
+#define tmanARG9( a1, a2, a3, a4, a5, a6, a7, a8, n, ... ) n
+#define tmanNARGS( ... )            tmanARG9( __VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0 )
+/* 1 for a parenthesized list, 0 for a single token */
+#define tmanIS_LIST( x )            tmanCALL( tmanARG2, ( tmanIS_LIST_PROBE x, 0, ~ ) )
+#define tmanIS_LIST_PROBE( ... )    ~, 1
+/* 1 for the token NONE, 0 for an identifier */
+#define tmanIS_NONE( x )            tmanCALL( tmanARG2, ( tmanCAT( tmanIS_NONE_PROBE_, x ), 0, ~ ) )
+#define tmanIS_NONE_PROBE_NONE      ~, 1
+/* Predecessor column as a parenthesized list, NONE is a list of one */
+#define tmanPREDS( pred )           tmanCAT( tmanPREDS_, tmanIS_LIST( pred ) )( pred )
+#define tmanPREDS_0( pred )         ( pred )
+#define tmanPREDS_1( pred )         pred
+/* M( name, p ) for every predecessor p of the list */
+#define tmanPREDS_EACH( M, name, list ) \
+    tmanCALL( tmanCAT( tmanEACH_, tmanNARGS list ), ( M, name, tmanUNPAREN list ) )
+#define tmanEACH_1( M, n, a )       M( n, a )
+#define tmanEACH_2( M, n, a, ... )  M( n, a ) tmanEACH_1( M, n, __VA_ARGS__ )
+#define tmanEACH_3( M, n, a, ... )  M( n, a ) tmanEACH_2( M, n, __VA_ARGS__ )
+#define tmanEACH_4( M, n, a, ... )  M( n, a ) tmanEACH_3( M, n, __VA_ARGS__ )
+#define tmanEACH_5( M, n, a, ... )  M( n, a ) tmanEACH_4( M, n, __VA_ARGS__ )
+#define tmanEACH_6( M, n, a, ... )  M( n, a ) tmanEACH_5( M, n, __VA_ARGS__ )
+#define tmanEACH_7( M, n, a, ... )  M( n, a ) tmanEACH_6( M, n, __VA_ARGS__ )
+#define tmanEACH_8( M, n, a, ... )  M( n, a ) tmanEACH_7( M, n, __VA_ARGS__ )
+/* Predecessors of a list, 0 for NONE */
+#define tmanPREDS_COUNT( list ) \
+    ( tmanNARGS list - tmanIS_NONE( tmanCALL( tmanARG1, ( tmanUNPAREN list, ~ ) ) ) )
+
+#define tmanPRED_CHECK( name, pred ) \
+    _Static_assert( ( int ) tmanID_##pred == tmanID_NONE || ( int ) tmanID_##pred < ( int ) tmanID_##name, \
+            "TMAN task " #name ": predecessor " #pred " must be declared before it" );
+#define tmanPRED_ID( name, pred )   tmanID_##pred,
+#define tmanPRED_NAME( name, pred ) "," #pred
+
+#define tmanTASKSET_ID( name, period, phase, deadline, wcetUs, pred, prio, code, stack ) \
+    tmanID_##name,
+
+/* Stack and control block of the entries that create a task */
+#define tmanTASKSET_STORAGE( name, period, phase, deadline, wcetUs, pred, prio, code, stack ) \
+    tmanCAT( tmanSTORAGE_, tmanIS_NONE( code ) )( name, stack )
+#define tmanSTORAGE_0( name, stack ) \
+    static StackType_t tmanStack_##name[( stack ) > 0 ? ( stack ) : 1]; \
+    static StaticTask_t tmanTcb_##name;
+#define tmanSTORAGE_1( name, stack )
+
+#define tmanTASKSET_CHECK( name, period, phase, deadline, wcetUs, pred, prio, code, stack ) \
+    tmanPREDS_EACH( tmanPRED_CHECK, name, tmanPREDS( pred ) ) \
+    _Static_assert( tmanPREDS_COUNT( tmanPREDS( pred ) ) <= TMAN_MAX_PREDECESSORS, \
+            "TMAN task " #name ": more predecessors than TMAN_MAX_PREDECESSORS" ); \
+    _Static_assert( ( period ) > 0 || tmanPREDS_COUNT( tmanPREDS( pred ) ) > 0, \
+            "TMAN task " #name ": needs a period or a predecessor" ); \
+    _Static_assert( ( prio ) < TMAN_PRIORITY_REGULATOR_TASK, \
+            "TMAN task " #name ": priority must be below the regulator task" );
+
+#define tmanTASKSET_UTIL( name, period, phase, deadline, wcetUs, pred, prio, code, stack ) \
+    + ( ( period ) > 0 ? ( ( unsigned long long ) ( wcetUs ) * TMAN_TASKSET_SCALE + ( period ) - 1 ) / \
+            ( ( period ) > 0 ? ( period ) : 1 ) : 0ULL )
+
+#define tmanTASKSET_ENTRY( name, period, phase, deadline, wcetUs, pred, prio, code, stack ) \
+    { #name, ( period ), ( phase ), ( deadline ), ( wcetUs ), \
+            { tmanPREDS_EACH( tmanPRED_ID, name, tmanPREDS( pred ) ) }, \
+            ( uint8_t ) tmanPREDS_COUNT( tmanPREDS( pred ) ), \
+            ( tmanPREDS_EACH( tmanPRED_NAME, name, tmanPREDS( pred ) ) ) + 1, \
+            tmanCAT( tmanENTRY_TASK_, tmanIS_NONE( code ) )( name, code, prio, stack ) },
+#define tmanENTRY_TASK_0( name, code, prio, stack ) \
+    ( code ), ( void * ) #name, ( prio ), ( stack ), tmanStack_##name, &tmanTcb_##name
+#define tmanENTRY_TASK_1( name, code, prio, stack ) \
+    NULL, ( void * ) #name, ( prio ), 0, NULL, NULL
+
+/* Task table, storage and checks of the set X, tickUs is the TMAN tick
+ * in microseconds, as given to TMAN_InitUs */
+#define TMAN_TASKSET_DEFINE( set, X, tickUs ) \
+    enum { X( tmanTASKSET_ID ) tmanID_COUNT }; \
+    X( tmanTASKSET_STORAGE ) \
+    X( tmanTASKSET_CHECK ) \
+    _Static_assert( tmanID_COUNT <= TMAN_MAX_TASKS && ( int ) tmanID_COUNT < tmanID_NONE, \
+            "TMAN task set " #set ": more tasks than TMAN_MAX_TASKS" ); \
+    _Static_assert( 0ULL X( tmanTASKSET_UTIL ) <= TMAN_TASKSET_SCALE * ( tickUs ) * TMAN_NUM_CORES, \
+            "TMAN task set " #set ": utilization above the number of cores" ); \
+    static const TMAN_TaskSetEntry_t set[] = { X( tmanTASKSET_ENTRY ) }
+
+/* Add the set to the framework, between TMAN_Init and TMAN_Start */
+#define TMAN_TASKSET_LOAD( set ) \
+    TMAN_TaskSetLoad( set, ( uint32_t ) ( sizeof( set ) / sizeof( set[0] ) ) )
+
+#endif	/* TMANTASKSET_H */
@@ -0,0 +1,16 @@
+/*
+ * Host stand-in for the UART driver, output goes to stdout.
+ */
+
+#ifndef __UART_H__
+#define __UART_H__
+
+#include <stdint.h>
+
+#define UART_SUCCESS 0
+#define UART_FAIL -1
+
+int UartInit(uint64_t pbclock, uint32_t br);
+void PrintStr(uint8_t *txStr);
+
+#endif
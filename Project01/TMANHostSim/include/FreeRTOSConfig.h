@@ -0,0 +1,51 @@
+/*
+ * Host configuration mirroring ../PIC32MX_TMANFramework/FreeRTOSConfig.h
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION					1
+#define configUSE_IDLE_HOOK						0
+#ifndef configUSE_TICK_HOOK
+#define configUSE_TICK_HOOK						0
+#endif
+#define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
+#define configCPU_CLOCK_HZ						( 80000000UL )
+#define configPERIPHERAL_CLOCK_HZ				( 40000000UL )
+#define configMAX_PRIORITIES					( 5UL )
+#define configMINIMAL_STACK_SIZE				( 190 )
+#define configTOTAL_HEAP_SIZE					( ( size_t ) 28000 )
+#define configMAX_TASK_NAME_LEN					( 8 )
+#define configUSE_16_BIT_TICKS					0
+#define configUSE_MUTEXES						1
+#define configUSE_COUNTING_SEMAPHORES			1
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#endif
+#ifndef configSUPPORT_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION         1
+#endif
+#define configUSE_TIME_SLICING                  0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS	1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	3
+
+#define INCLUDE_vTaskPrioritySet			1
+#define INCLUDE_uxTaskPriorityGet			1
+#define INCLUDE_vTaskDelete					1
+#define INCLUDE_vTaskSuspend				1
+#define INCLUDE_vTaskDelayUntil				1
+#define INCLUDE_vTaskDelay					1
+#define INCLUDE_xTaskAbortDelay				1
+#define INCLUDE_eTaskGetState				1
+#define INCLUDE_xTaskGetHandle              1
+
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+void vAssertCalled( const char *pcFileName, unsigned long ulLine );
+
+void TMAN_TraceSwitchedIn( void );
+void TMAN_TraceSwitchedOut( void );
+#define traceTASK_SWITCHED_IN()     TMAN_TraceSwitchedIn()
+#define traceTASK_SWITCHED_OUT()    TMAN_TraceSwitchedOut()
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,29 @@
+/*
+ * Host stand-in for the XC32 device header.
+ */
+
+#ifndef SIM_XC_H
+#define SIM_XC_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/* CP0 Count register, driven by the simulator virtual clock */
+#define _CP0_GET_COUNT()        ( ( uint32_t ) ullSimGetCycles() )
+
+/* Timer2 registers, the simulator reads them to start its periodic interrupt */
+typedef struct { uint32_t ON, TCS, TCKPS, T32; } simT2CON_t;
+typedef struct { uint32_t T2IF; } simIFS0_t;
+typedef struct { uint32_t T2IP; } simIPC2_t;
+typedef struct { uint32_t T2IE; } simIEC0_t;
+extern simT2CON_t T2CONbits;
+extern simIFS0_t IFS0bits;
+extern simIPC2_t IPC2bits;
+extern simIEC0_t IEC0bits;
+extern uint32_t TMR2, PR2;
+#define __attribute__( x )
+
+/* Start the simulator periodic interrupt from the Timer2 configuration */
+void vSimTimer2Start( void (*pxHandler)( void ) );
+
+#endif /* SIM_XC_H */
@@ -0,0 +1,296 @@
+/*
+ * Host build of the TMAN demo
+ * - Runs the task set of mainTMAN.c on the simulation kernel, in virtual
+ *   time, and prints the same "name, tick" lines the board sends to the UART
+ *
+ * Usage: tmanhost [hyperperiods] [-q] [-a]
+ * - hyperperiods: number of hyperperiods to simulate, 10 by default
+ * - -q: do not print the job lines, only the final statistics
+ * - -a: run task S of period 50 instead, and add task N of period 2 at
+ *   TMAN tick 5, while the regulator sleeps towards the next release of S
+ *
+ * Build with EXTRA="-DRATE_GROUPS=1" to run A/B, C/D and E/F as three rate
+ * groups instead of six tasks
+ *
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xc.h>
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+/* App includes */
+#include "../UART/uart.h"
+#include "tman.h"
+#include "tmantaskset.h"
+
+/* Framework configuration parameters */
+#define TMAN_TICK                   200
+#define TMAN_NUMBER_TASK            6
+/* Hyperperiod of the task set in TMAN ticks */
+#define TMAN_HYPERPERIOD            9
+/* Simulated execution time of each job in core timer cycles, close to the
+ * IMAXCOUNT x JMAXCOUNT busy loop of the board demo */
+#ifndef JOB_CYCLES
+#define JOB_CYCLES                  ( simCYCLES_PER_TICK / 2 )
+#endif
+/* Tasks of equal period share one FreeRTOS task when set */
+#ifndef RATE_GROUPS
+#define RATE_GROUPS                 0
+#endif
+#define TMAN_NUMBER_GROUP           3
+/* Hyperperiod of the -a task set, and TMAN tick at which it adds task N */
+#define LATE_HYPERPERIOD            50
+#define LATE_ADD_TICK               5
+
+void defaultTask( void *pvParam );
+
+/* The group tasks run the jobs, the members get no task of their own */
+#if( RATE_GROUPS == 1 )
+    #define DEMO_CODE               NONE
+    #define DEMO_STACK              0
+#else
+    #define DEMO_CODE               defaultTask
+    #define DEMO_STACK              configMINIMAL_STACK_SIZE
+#endif
+
+/* Task set of mainTMAN.c, see tmantaskset.h */
+#define DEMO_TASKS( X ) \
+    X( A, 1, 0, 0, 0, NONE, tskIDLE_PRIORITY + 3, DEMO_CODE, DEMO_STACK ) \
+    X( B, 1, 0, 0, 0, NONE, tskIDLE_PRIORITY + 3, DEMO_CODE, DEMO_STACK ) \
+    X( C, 3, 0, 0, 0, NONE, tskIDLE_PRIORITY + 2, DEMO_CODE, DEMO_STACK ) \
+    X( D, 3, 1, 0, 0, NONE, tskIDLE_PRIORITY + 2, DEMO_CODE, DEMO_STACK ) \
+    X( E, 9, 2, 0, 0, D,    tskIDLE_PRIORITY + 1, DEMO_CODE, DEMO_STACK ) \
+    X( F, 9, 3, 0, 0, NONE, tskIDLE_PRIORITY + 1, DEMO_CODE, DEMO_STACK )
+
+/* Task table and static storage of the tasks, no task uses the heap */
+TMAN_TASKSET_DEFINE( demoTaskSet, DEMO_TASKS, TMAN_TICK * 1000UL );
+
+/* Stacks and control blocks of tasks S and N of -a, and of the task adding N */
+static StackType_t arrLateStacks[2][configMINIMAL_STACK_SIZE];
+static StaticTask_t arrLateBuffers[2];
+static StackType_t arrAdderStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t adderBuffer;
+
+#if( RATE_GROUPS == 1 )
+/* Stacks and control blocks of the group tasks */
+static StackType_t arrGroupStacks[TMAN_NUMBER_GROUP][configMINIMAL_STACK_SIZE];
+static StaticTask_t arrGroupBuffers[TMAN_NUMBER_GROUP];
+#endif
+
+/* Job lines are not printed when set */
+static uint32_t g_quiet = 0;
+/* Run tasks S and N instead of the task set when set */
+static uint32_t g_addLate = 0;
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TICK_HOOK )
+void vApplicationTickHook( void )
+{
+    TMAN_TickFromISR();
+}
+#else
+void vApplicationTickHook( void )
+{
+}
+#endif
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+void TMAN_TimerInterruptHandler( void );
+#endif
+
+void defaultJob( void *pvParam )
+{
+    TickType_t tick;
+    uint8_t mesg[80];
+
+    if( !g_quiet )
+    {
+        tick = xTaskGetTickCount();
+
+        sprintf( ( char * ) mesg, "%s, %u\n", (char *) pvParam, (uint32_t) tick );
+        PrintStr( mesg );
+    }
+
+    /* Stands in for the busy loop of the board demo */
+    vSimConsumeCycles( JOB_CYCLES );
+}
+
+void defaultTask( void *pvParam )
+{
+    uint32_t err;
+
+    for(;;)
+    {
+        err = TMAN_TaskWaitPeriodSelf();
+
+        if( err )
+            exit(err);
+
+        defaultJob( pvParam );
+    }
+}
+
+/* Add a periodic task of -a, in its static storage */
+static void lateTaskAdd( const char *pcName, uint32_t period, UBaseType_t uxPriority, uint32_t slot )
+{
+    uint32_t err;
+
+    err = TMAN_TaskAdd( pcName, NULL );
+    if( !err )
+        err = TMAN_TaskRegisterAttributes( pcName, period, 0, 0, "" );
+    if( !err )
+        err = TMAN_TaskCreate( pcName, defaultTask, ( void * ) pcName, uxPriority,
+                configMINIMAL_STACK_SIZE, arrLateStacks[slot], &arrLateBuffers[slot] );
+
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+}
+
+/* Add task N in the middle of TMAN tick LATE_ADD_TICK, the first release of
+ * S already passed and the next one is 45 TMAN ticks away */
+void adderTask( void *pvParam )
+{
+    ( void ) pvParam;
+
+    vTaskDelay( LATE_ADD_TICK * TMAN_TICK + TMAN_TICK / 2 );
+
+    lateTaskAdd( "N", 2, tskIDLE_PRIORITY + 2, 1 );
+
+    vTaskDelete( NULL );
+}
+
+int main( int argc, char **argv )
+{
+    /* Iteration variable and error code */
+    uint32_t i, err;
+    /* Number of hyperperiods to simulate */
+    uint32_t hyperperiods = 10;
+#if( RATE_GROUPS == 1 )
+    /* Rate groups and their members, tasks of equal period */
+    const char *arrGroupNames[TMAN_NUMBER_GROUP] = { "AB", "CD", "EF" };
+    const char *arrGroupMembers[TMAN_NUMBER_GROUP] = { "A,B", "C,D", "E,F" };
+#endif
+
+    for( i = 1; i < ( uint32_t ) argc; i++ )
+    {
+        if( strcmp( argv[i], "-q" ) == 0 )
+            g_quiet = 1;
+        else if( strcmp( argv[i], "-a" ) == 0 )
+            g_addLate = 1;
+        else
+            hyperperiods = ( uint32_t ) strtoul( argv[i], NULL, 10 );
+    }
+
+    /* The tick count is 32 bits wide, stop before it wraps */
+    if( hyperperiods == 0 ||
+            hyperperiods > 0xFFFFFFFFUL / ( LATE_HYPERPERIOD * TMAN_TICK ) )
+    {
+        fprintf( stderr, "usage: %s [hyperperiods] [-q] [-a]\n", argv[0] );
+        return 1;
+    }
+    vSimSetEndTick( hyperperiods * ( g_addLate ? LATE_HYPERPERIOD : TMAN_HYPERPERIOD ) * TMAN_TICK );
+
+    /* Initialize framework */
+    err = TMAN_Init( TMAN_TICK, 0, NULL );
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+#if( TMAN_TIME_SOURCE == TMAN_TIME_SOURCE_TIMER )
+    /* The framework configured Timer2, let the simulator raise its interrupt */
+    vSimTimer2Start( TMAN_TimerInterruptHandler );
+#endif
+
+    /* Add the task set and create its tasks */
+    if( g_addLate )
+        lateTaskAdd( "S", LATE_HYPERPERIOD, tskIDLE_PRIORITY + 3, 0 );
+    else
+        err = TMAN_TASKSET_LOAD( demoTaskSet );
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+    /* Build the release table for the registered task set */
+    err = TMAN_Start();
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+    if( g_addLate )
+    {
+        /* Below the tasks of the framework, it only sleeps and adds N */
+        if( xTaskCreateStatic( adderTask, "Adder", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, arrAdderStack, &adderBuffer ) == NULL )
+        {
+            printf("error: %d\n", TMAN_NO_MEM);
+            exit(TMAN_NO_MEM);
+        }
+    }
+
+#if( RATE_GROUPS == 1 )
+    for( i = 0; i < TMAN_NUMBER_TASK && !g_addLate; i++ )
+    {
+        /* The group tasks call the job of each member */
+        err = TMAN_TaskSetJob( demoTaskSet[i].pcName, defaultJob, demoTaskSet[i].pvParameters );
+        /* Exit program in case function returns an error code */
+        if( err )
+        {
+            printf("error: %d\n", err);
+            exit(err);
+        }
+    }
+
+    for( i = 0; i < TMAN_NUMBER_GROUP && !g_addLate; i++ )
+    {
+        /* Fuse the tasks of equal period, in their static storage */
+        err = TMAN_GroupCreate( arrGroupNames[i],
+                arrGroupMembers[i],
+                demoTaskSet[2 * i].uxPriority,
+                configMINIMAL_STACK_SIZE,
+                arrGroupStacks[i],
+                &arrGroupBuffers[i] );
+        /* Exit program in case function returns an error code */
+        if( err )
+        {
+            printf("error: %d\n", err);
+            exit(err);
+        }
+    }
+#endif
+
+    /* Returns once the last simulated tick has been processed */
+    vTaskStartScheduler();
+
+    if( g_addLate )
+    {
+        TMAN_TaskStats( "S" );
+        TMAN_TaskStats( "N" );
+    }
+    else
+    {
+        for( i = 0; i < TMAN_NUMBER_TASK; i++ )
+            TMAN_TaskStats( demoTaskSet[i].pcName );
+    }
+    printf( "context switches: %llu\n",
+            ( unsigned long long ) ullSimGetContextSwitches() );
+
+    TMAN_Close();
+
+    return 0;
+}
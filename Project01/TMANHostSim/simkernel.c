@@ -0,0 +1,1080 @@
+/*
+ * Host simulation kernel for the TMAN framework.
+ *
+ * Every FreeRTOS task is a coroutine scheduled by a single host thread, so
+ * runs are fully deterministic. A ucontext only bootstraps the task stack,
+ * switches use _setjmp/_longjmp, which do not save the signal mask and so
+ * avoid a system call per context switch. The scheduler follows the
+ * FreeRTOS rules the framework depends on: fixed priority preemption,
+ * FIFO order inside a priority (configUSE_TIME_SLICING is 0) and blocked
+ * tasks woken by priority.
+ *
+ * Time is virtual. The core timer advances only through vSimConsumeCycles()
+ * or, when no task is ready, by jumping to the next pending event.
+ */
+
+#define _XOPEN_SOURCE 700
+/* Fortified longjmp refuses to jump between task stacks */
+#undef _FORTIFY_SOURCE
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <xc.h>
+#include "../UART/uart.h"
+
+#define simSTACK_SIZE               ( 64 * 1024 )
+#define simNO_WAKE                  ( ( uint64_t ) -1 )
+
+typedef enum
+{
+    simWAIT_NONE = 0,
+    simWAIT_DELAY,
+    simWAIT_QUEUE_RECEIVE,
+    simWAIT_QUEUE_SEND,
+    simWAIT_NOTIFY
+} SimWait_t;
+
+struct tskTaskControlBlock
+{
+    ucontext_t xContext;
+    jmp_buf xJump;
+    BaseType_t xStarted;
+    void *pvStack;
+    char pcName[ configMAX_TASK_NAME_LEN ];
+    UBaseType_t uxPriority;
+    eTaskState eState;
+    /* Order inside the ready list of a priority */
+    uint64_t ullReadySeq;
+    /* Order inside the waiting list of a kernel object */
+    uint64_t ullBlockSeq;
+    SimWait_t eWait;
+    void *pvWaitObject;
+    UBaseType_t uxWaitIndex;
+    /* Tick at which a timed block expires, simNO_WAKE when unbounded */
+    uint64_t ullWakeTick;
+    BaseType_t xTimedOut;
+    uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+    uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
+    void *pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
+#endif
+    TaskFunction_t pxTaskCode;
+    void *pvParameters;
+    struct tskTaskControlBlock *pxNext;
+};
+
+struct QueueDefinition
+{
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    UBaseType_t uxMessagesWaiting;
+    UBaseType_t uxReadIndex;
+    uint8_t *pucStorage;
+    uint8_t ucStaticStorage;
+};
+
+/* Kernel state */
+static struct tskTaskControlBlock *pxTaskList = NULL;
+static struct tskTaskControlBlock *pxCurrentTCB = NULL;
+static jmp_buf xSchedulerJump;
+static uint64_t ullSeq = 0;
+static uint64_t ullTickCount = 0;
+static uint64_t ullEndTick = 0;
+static uint64_t ullCycles = 0;
+static uint64_t ullContextSwitches = 0;
+static UBaseType_t uxSchedulerSuspended = 0;
+static UBaseType_t uxCriticalNesting = 0;
+static BaseType_t xInISR = pdFALSE;
+static BaseType_t xSchedulerRunning = pdFALSE;
+static BaseType_t xYieldPending = pdFALSE;
+
+/* Optional periodic hardware timer */
+static uint64_t ullTimerPeriod = 0;
+static uint64_t ullTimerNext = 0;
+static void (*pxTimerHandler)( void ) = NULL;
+
+/* Timer2 registers written by the framework when it owns a hardware timer */
+simT2CON_t T2CONbits;
+simIFS0_t IFS0bits;
+simIPC2_t IPC2bits;
+simIEC0_t IEC0bits;
+uint32_t TMR2, PR2;
+
+/* Trace hooks need the task being switched in or out */
+#define simSWITCH_IN( pxTCB )   do { pxCurrentTCB = ( pxTCB ); traceTASK_SWITCHED_IN(); } while( 0 )
+
+void vAssertCalled( const char *pcFileName, unsigned long ulLine )
+{
+    fprintf( stderr, "assert failed: %s:%lu\n", pcFileName, ulLine );
+    abort();
+}
+
+void *pvPortMalloc( size_t xSize )
+{
+    return malloc( xSize );
+}
+
+void vPortFree( void *pv )
+{
+    free( pv );
+}
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return configTOTAL_HEAP_SIZE;
+}
+
+int UartInit( uint64_t pbclock, uint32_t br )
+{
+    ( void ) pbclock;
+    ( void ) br;
+    return UART_SUCCESS;
+}
+
+void PrintStr( uint8_t *txStr )
+{
+    fputs( ( const char * ) txStr, stdout );
+}
+
+/*-----------------------------------------------------------*/
+
+static struct tskTaskControlBlock * prvGetTCB( TaskHandle_t xTask )
+{
+    return ( xTask == NULL ) ? pxCurrentTCB : xTask;
+}
+
+static void prvMakeReady( struct tskTaskControlBlock *pxTCB )
+{
+    pxTCB->eState = eReady;
+    pxTCB->eWait = simWAIT_NONE;
+    pxTCB->pvWaitObject = NULL;
+    pxTCB->ullWakeTick = simNO_WAKE;
+    pxTCB->ullReadySeq = ++ullSeq;
+}
+
+static struct tskTaskControlBlock * prvHighestReady( void )
+{
+    struct tskTaskControlBlock *pxTCB, *pxBest = NULL;
+
+    for( pxTCB = pxTaskList; pxTCB != NULL; pxTCB = pxTCB->pxNext )
+    {
+        if( pxTCB->eState != eReady )
+            continue;
+        if( pxBest == NULL || pxTCB->uxPriority > pxBest->uxPriority ||
+                ( pxTCB->uxPriority == pxBest->uxPriority && pxTCB->ullReadySeq < pxBest->ullReadySeq ) )
+            pxBest = pxTCB;
+    }
+
+    return pxBest;
+}
+
+/* Return to the scheduler loop, which picks the next task to run */
+static void prvSwitchOut( void )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+
+    traceTASK_SWITCHED_OUT();
+    if( _setjmp( pxTCB->xJump ) == 0 )
+        _longjmp( xSchedulerJump, 1 );
+}
+
+/* Preempt the caller when a higher priority task became ready */
+static void prvPreemptionPoint( void )
+{
+    struct tskTaskControlBlock *pxBest;
+
+    if( xInISR || !xSchedulerRunning || pxCurrentTCB == NULL )
+        return;
+
+    if( uxSchedulerSuspended != 0 || uxCriticalNesting != 0 )
+    {
+        xYieldPending = pdTRUE;
+        return;
+    }
+
+    pxBest = prvHighestReady();
+    if( pxBest != NULL && pxBest != pxCurrentTCB &&
+            ( pxCurrentTCB->eState != eReady || pxBest->uxPriority > pxCurrentTCB->uxPriority ) )
+        prvSwitchOut();
+    else if( pxCurrentTCB->eState != eReady )
+        prvSwitchOut();
+}
+
+/* Block the calling task; returns pdFALSE when the block timed out */
+static BaseType_t prvBlock( SimWait_t eWait, void *pvObject, UBaseType_t uxIndex, TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+
+    configASSERT( pxTCB != NULL && !xInISR );
+    configASSERT( uxSchedulerSuspended == 0 );
+
+    pxTCB->eState = eBlocked;
+    pxTCB->eWait = eWait;
+    pxTCB->pvWaitObject = pvObject;
+    pxTCB->uxWaitIndex = uxIndex;
+    pxTCB->ullBlockSeq = ++ullSeq;
+    pxTCB->xTimedOut = pdFALSE;
+    pxTCB->ullWakeTick = ( xTicksToWait == portMAX_DELAY ) ? simNO_WAKE : ullTickCount + xTicksToWait;
+
+    prvSwitchOut();
+
+    return ( pxTCB->xTimedOut == pdFALSE ) ? pdTRUE : pdFALSE;
+}
+
+/* Wake the highest priority task waiting on an object */
+static struct tskTaskControlBlock * prvWakeWaiter( SimWait_t eWait, void *pvObject )
+{
+    struct tskTaskControlBlock *pxTCB, *pxBest = NULL;
+
+    for( pxTCB = pxTaskList; pxTCB != NULL; pxTCB = pxTCB->pxNext )
+    {
+        if( pxTCB->eState != eBlocked || pxTCB->eWait != eWait || pxTCB->pvWaitObject != pvObject )
+            continue;
+        if( pxBest == NULL || pxTCB->uxPriority > pxBest->uxPriority ||
+                ( pxTCB->uxPriority == pxBest->uxPriority && pxTCB->ullBlockSeq < pxBest->ullBlockSeq ) )
+            pxBest = pxTCB;
+    }
+
+    if( pxBest != NULL )
+        prvMakeReady( pxBest );
+
+    return pxBest;
+}
+
+static BaseType_t prvHigherThanCurrent( struct tskTaskControlBlock *pxTCB )
+{
+    return ( pxTCB != NULL && ( pxCurrentTCB == NULL || pxTCB->uxPriority > pxCurrentTCB->uxPriority ) ) ? pdTRUE : pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+/* Interrupts and virtual time */
+
+static uint64_t prvNextTickCycles( void )
+{
+    return ( ullTickCount + 1 ) * ( uint64_t ) simCYCLES_PER_TICK;
+}
+
+static void prvTickInterrupt( void )
+{
+    struct tskTaskControlBlock *pxTCB;
+
+    ullTickCount++;
+
+    for( pxTCB = pxTaskList; pxTCB != NULL; pxTCB = pxTCB->pxNext )
+    {
+        if( pxTCB->eState == eBlocked && pxTCB->ullWakeTick != simNO_WAKE &&
+                pxTCB->ullWakeTick <= ullTickCount )
+        {
+            pxTCB->xTimedOut = ( pxTCB->eWait != simWAIT_DELAY ) ? pdTRUE : pdFALSE;
+            prvMakeReady( pxTCB );
+        }
+    }
+
+#if( configUSE_TICK_HOOK == 1 )
+    vApplicationTickHook();
+#endif
+}
+
+/* Deliver every interrupt due at the current cycle count */
+static void prvServiceInterrupts( void )
+{
+    xInISR = pdTRUE;
+
+    while( ullCycles >= prvNextTickCycles() )
+        prvTickInterrupt();
+
+    while( pxTimerHandler != NULL && ullTimerPeriod != 0 && ullCycles >= ullTimerNext )
+    {
+        ullTimerNext += ullTimerPeriod;
+        pxTimerHandler();
+    }
+
+    xInISR = pdFALSE;
+}
+
+static uint64_t prvNextInterruptCycles( void )
+{
+    uint64_t ullNext = prvNextTickCycles();
+
+    if( pxTimerHandler != NULL && ullTimerPeriod != 0 && ullTimerNext < ullNext )
+        ullNext = ullTimerNext;
+
+    return ullNext;
+}
+
+/* Nothing is ready: jump the clock to the next event that can wake a task */
+static void prvIdleAdvance( void )
+{
+    struct tskTaskControlBlock *pxTCB;
+    uint64_t ullWake = simNO_WAKE;
+
+    for( pxTCB = pxTaskList; pxTCB != NULL; pxTCB = pxTCB->pxNext )
+    {
+        if( pxTCB->eState == eBlocked && pxTCB->ullWakeTick < ullWake )
+            ullWake = pxTCB->ullWakeTick;
+    }
+
+    if( ullWake > ullEndTick )
+        ullWake = ullEndTick;
+
+    /* The tick hook and the hardware timer have to see every interrupt */
+    if( configUSE_TICK_HOOK == 1 || ( pxTimerHandler != NULL && ullTimerPeriod != 0 ) )
+    {
+        ullCycles = prvNextInterruptCycles();
+    }
+    else if( ullWake > ullTickCount + 1 )
+    {
+        ullTickCount = ullWake - 1;
+        ullCycles = prvNextTickCycles();
+    }
+    else
+    {
+        ullCycles = prvNextTickCycles();
+    }
+
+    prvServiceInterrupts();
+}
+
+void vSimConsumeCycles( uint64_t ullWork )
+{
+    uint64_t ullNext;
+
+    configASSERT( uxCriticalNesting == 0 );
+
+    while( ullWork > 0 && ullTickCount < ullEndTick )
+    {
+        ullNext = prvNextInterruptCycles();
+
+        if( ullCycles + ullWork < ullNext )
+        {
+            ullCycles += ullWork;
+            return;
+        }
+
+        ullWork -= ullNext - ullCycles;
+        ullCycles = ullNext;
+        prvServiceInterrupts();
+        prvPreemptionPoint();
+    }
+
+    /* Out of simulated time: park the task for good */
+    if( ullTickCount >= ullEndTick )
+        prvBlock( simWAIT_DELAY, NULL, 0, portMAX_DELAY );
+}
+
+uint64_t ullSimGetCycles( void )
+{
+    return ullCycles;
+}
+
+uint64_t ullSimGetContextSwitches( void )
+{
+    return ullContextSwitches;
+}
+
+void vSimSetEndTick( TickType_t xEndTick )
+{
+    ullEndTick = xEndTick;
+}
+
+void vSimTimerStart( uint64_t ullPeriodCycles, void (*pxHandler)( void ) )
+{
+    ullTimerPeriod = ullPeriodCycles;
+    ullTimerNext = ullCycles + ullPeriodCycles;
+    pxTimerHandler = pxHandler;
+}
+
+void vSimTimer2Start( void (*pxHandler)( void ) )
+{
+    /* TCKPS encodes the type B timer prescaler */
+    static const uint32_t ulPrescaler[ 8 ] = { 1, 2, 4, 8, 16, 32, 64, 256 };
+
+    if( T2CONbits.ON )
+    {
+        vSimTimerStart( ( uint64_t ) ( PR2 + 1 ) * ulPrescaler[ T2CONbits.TCKPS & 7 ],
+                        pxHandler );
+    }
+}
+
+/*-----------------------------------------------------------*/
+/* Critical sections */
+
+void vPortEnterCritical( void )
+{
+    uxCriticalNesting++;
+}
+
+void vPortExitCritical( void )
+{
+    configASSERT( uxCriticalNesting > 0 );
+    uxCriticalNesting--;
+    if( uxCriticalNesting == 0 && xYieldPending && uxSchedulerSuspended == 0 )
+    {
+        xYieldPending = pdFALSE;
+        prvPreemptionPoint();
+    }
+}
+
+UBaseType_t uxPortSetInterruptMaskFromISR( void )
+{
+    return 0;
+}
+
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSaved )
+{
+    ( void ) uxSaved;
+}
+
+void vPortYieldFromISR( BaseType_t xSwitchRequired )
+{
+    /* The scheduler re-evaluates the ready list after every interrupt */
+    ( void ) xSwitchRequired;
+}
+
+/*-----------------------------------------------------------*/
+/* Tasks */
+
+static void prvTaskEntry( void )
+{
+    pxCurrentTCB->pxTaskCode( pxCurrentTCB->pvParameters );
+
+    /* FreeRTOS tasks must never return */
+    configASSERT( 0 );
+}
+
+static TaskHandle_t prvCreateTask( TaskFunction_t pxTaskCode, const char * const pcName,
+                                   void * const pvParameters, UBaseType_t uxPriority )
+{
+    /* getcontext() is declared to return twice, so -Wclobbered (-Wextra)
+     * flags locals live across it. The saved context is only a template for
+     * makecontext() and is never resumed here, volatile just quiets that */
+    struct tskTaskControlBlock * volatile pxTCB;
+    struct tskTaskControlBlock **ppxTail;
+
+    pxTCB = calloc( 1, sizeof( *pxTCB ) );
+    if( pxTCB == NULL )
+        return NULL;
+
+    pxTCB->pvStack = malloc( simSTACK_SIZE );
+    if( pxTCB->pvStack == NULL )
+    {
+        free( pxTCB );
+        return NULL;
+    }
+
+    strncpy( pxTCB->pcName, pcName, configMAX_TASK_NAME_LEN - 1 );
+    if( uxPriority >= configMAX_PRIORITIES )
+        uxPriority = configMAX_PRIORITIES - 1;
+    pxTCB->uxPriority = uxPriority;
+    pxTCB->pxTaskCode = pxTaskCode;
+    pxTCB->pvParameters = pvParameters;
+
+    getcontext( &pxTCB->xContext );
+    pxTCB->xContext.uc_stack.ss_sp = pxTCB->pvStack;
+    pxTCB->xContext.uc_stack.ss_size = simSTACK_SIZE;
+    pxTCB->xContext.uc_link = NULL;
+    makecontext( &pxTCB->xContext, prvTaskEntry, 0 );
+
+    prvMakeReady( pxTCB );
+
+    /* Keep creation order so scans are deterministic */
+    for( ppxTail = &pxTaskList; *ppxTail != NULL; ppxTail = &( *ppxTail )->pxNext );
+    *ppxTail = pxTCB;
+
+    if( prvHigherThanCurrent( pxTCB ) )
+        prvPreemptionPoint();
+
+    return pxTCB;
+}
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName,
+                        uint32_t usStackDepth, void * const pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+    TaskHandle_t xHandle;
+
+    ( void ) usStackDepth;
+
+    xHandle = prvCreateTask( pxTaskCode, pcName, pvParameters, uxPriority );
+    if( pxCreatedTask != NULL )
+        *pxCreatedTask = xHandle;
+
+    return ( xHandle != NULL ) ? pdPASS : errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+}
+
+TaskHandle_t xTaskCreateStatic( TaskFunction_t pxTaskCode, const char * const pcName,
+                                uint32_t ulStackDepth, void * const pvParameters,
+                                UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                                StaticTask_t * const pxTaskBuffer )
+{
+    /* Host stacks must be far larger than the PIC32 ones, the buffers given
+     * are only checked for presence */
+    ( void ) ulStackDepth;
+
+    if( puxStackBuffer == NULL || pxTaskBuffer == NULL )
+        return NULL;
+
+    return prvCreateTask( pxTaskCode, pcName, pvParameters, uxPriority );
+}
+
+void vTaskDelete( TaskHandle_t xTaskToDelete )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTaskToDelete );
+
+    /* Stacks are leaked on purpose, a deleting task may still run on it */
+    pxTCB->eState = eDeleted;
+    if( pxTCB == pxCurrentTCB )
+        prvSwitchOut();
+}
+
+void vTaskDelay( TickType_t xTicksToDelay )
+{
+    if( xTicksToDelay > 0 )
+        prvBlock( simWAIT_DELAY, NULL, 0, xTicksToDelay );
+}
+
+BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement )
+{
+    TickType_t xNow = ( TickType_t ) ullTickCount;
+    TickType_t xWake = *pxPreviousWakeTime + xTimeIncrement;
+    BaseType_t xShouldDelay;
+
+    /* Same wrap handling as tasks.c */
+    if( xNow < *pxPreviousWakeTime )
+        xShouldDelay = ( xWake < *pxPreviousWakeTime && xWake > xNow ) ? pdTRUE : pdFALSE;
+    else
+        xShouldDelay = ( xWake < *pxPreviousWakeTime || xWake > xNow ) ? pdTRUE : pdFALSE;
+
+    *pxPreviousWakeTime = xWake;
+
+    if( xShouldDelay )
+        prvBlock( simWAIT_DELAY, NULL, 0, xWake - xNow );
+
+    return xShouldDelay;
+}
+
+void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement )
+{
+    ( void ) xTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement );
+}
+
+BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTask );
+
+    if( pxTCB->eState != eBlocked )
+        return pdFAIL;
+
+    /* Like tasks.c, an aborted wait on an object reports a timeout */
+    pxTCB->xTimedOut = ( pxTCB->eWait != simWAIT_DELAY ) ? pdTRUE : pdFALSE;
+    prvMakeReady( pxTCB );
+    if( prvHigherThanCurrent( pxTCB ) )
+        prvPreemptionPoint();
+
+    return pdPASS;
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+    return ( TickType_t ) ullTickCount;
+}
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+    return ( TickType_t ) ullTickCount;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+    return pxCurrentTCB;
+}
+
+char * pcTaskGetName( TaskHandle_t xTaskToQuery )
+{
+    return prvGetTCB( xTaskToQuery )->pcName;
+}
+
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
+void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
+{
+    if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+        prvGetTCB( xTaskToSet )->pvThreadLocalStoragePointers[ xIndex ] = pvValue;
+}
+
+void * pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex )
+{
+    if( xIndex >= configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+        return NULL;
+    return prvGetTCB( xTaskToQuery )->pvThreadLocalStoragePointers[ xIndex ];
+}
+#endif
+
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTask );
+
+    if( uxNewPriority >= configMAX_PRIORITIES )
+        uxNewPriority = configMAX_PRIORITIES - 1;
+
+    if( pxTCB->uxPriority == uxNewPriority )
+        return;
+
+    pxTCB->uxPriority = uxNewPriority;
+
+    /* The task moves to the end of its new ready list */
+    if( pxTCB->eState == eReady )
+        pxTCB->ullReadySeq = ++ullSeq;
+
+    prvPreemptionPoint();
+}
+
+UBaseType_t uxTaskPriorityGet( TaskHandle_t xTask )
+{
+    return prvGetTCB( xTask )->uxPriority;
+}
+
+UBaseType_t uxTaskPriorityGetFromISR( TaskHandle_t xTask )
+{
+    return prvGetTCB( xTask )->uxPriority;
+}
+
+void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTaskToSuspend );
+
+    pxTCB->eState = eSuspended;
+    if( pxTCB == pxCurrentTCB && !xInISR )
+        prvSwitchOut();
+}
+
+void vTaskResume( TaskHandle_t xTaskToResume )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTaskToResume );
+
+    if( pxTCB->eState != eSuspended )
+        return;
+
+    prvMakeReady( pxTCB );
+    if( prvHigherThanCurrent( pxTCB ) )
+        prvPreemptionPoint();
+}
+
+BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTaskToResume );
+
+    if( pxTCB->eState != eSuspended )
+        return pdFALSE;
+
+    prvMakeReady( pxTCB );
+    return prvHigherThanCurrent( pxTCB );
+}
+
+void vTaskSuspendAll( void )
+{
+    uxSchedulerSuspended++;
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+    configASSERT( uxSchedulerSuspended > 0 );
+
+    uxSchedulerSuspended--;
+    if( uxSchedulerSuspended == 0 && uxCriticalNesting == 0 && xYieldPending )
+    {
+        xYieldPending = pdFALSE;
+        prvPreemptionPoint();
+        return pdTRUE;
+    }
+
+    return pdFALSE;
+}
+
+eTaskState eTaskGetState( TaskHandle_t xTask )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTask );
+
+    if( pxTCB == pxCurrentTCB && pxTCB->eState == eReady )
+        return eRunning;
+    return pxTCB->eState;
+}
+
+void vTaskYield( void )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+
+    /* Move behind the other ready tasks of the same priority */
+    pxTCB->ullReadySeq = ++ullSeq;
+    prvSwitchOut();
+}
+
+void vTaskStartScheduler( void )
+{
+    struct tskTaskControlBlock *pxNext;
+
+    if( ullEndTick == 0 )
+        ullEndTick = portMAX_DELAY;
+
+    xSchedulerRunning = pdTRUE;
+
+    while( ullTickCount < ullEndTick )
+    {
+        pxNext = prvHighestReady();
+
+        if( pxNext == NULL )
+        {
+            prvIdleAdvance();
+            continue;
+        }
+
+        if( pxNext != pxCurrentTCB )
+            ullContextSwitches++;
+
+        simSWITCH_IN( pxNext );
+        if( _setjmp( xSchedulerJump ) == 0 )
+        {
+            if( pxNext->xStarted )
+                _longjmp( pxNext->xJump, 1 );
+
+            /* First run of the task, enter it on its own stack */
+            pxNext->xStarted = pdTRUE;
+            setcontext( &pxNext->xContext );
+        }
+    }
+
+    xSchedulerRunning = pdFALSE;
+    pxCurrentTCB = NULL;
+}
+
+void vTaskEndScheduler( void )
+{
+    ullEndTick = ullTickCount;
+    if( pxCurrentTCB != NULL && !xInISR )
+        prvBlock( simWAIT_DELAY, NULL, 0, portMAX_DELAY );
+}
+
+/*-----------------------------------------------------------*/
+/* Direct to task notifications */
+
+#define simNOTIFY_NOT_WAITING       ( 0 )
+#define simNOTIFY_WAITING           ( 1 )
+#define simNOTIFY_RECEIVED          ( 2 )
+
+static BaseType_t prvNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndex, uint32_t ulValue,
+                             eNotifyAction eAction, uint32_t *pulPrevious )
+{
+    struct tskTaskControlBlock *pxTCB = xTaskToNotify;
+    uint8_t ucOriginalState;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT( pxTCB != NULL && uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+    if( pulPrevious != NULL )
+        *pulPrevious = pxTCB->ulNotifiedValue[ uxIndex ];
+
+    ucOriginalState = pxTCB->ucNotifyState[ uxIndex ];
+    pxTCB->ucNotifyState[ uxIndex ] = simNOTIFY_RECEIVED;
+
+    switch( eAction )
+    {
+        case eSetBits:
+            pxTCB->ulNotifiedValue[ uxIndex ] |= ulValue;
+            break;
+        case eIncrement:
+            pxTCB->ulNotifiedValue[ uxIndex ]++;
+            break;
+        case eSetValueWithOverwrite:
+            pxTCB->ulNotifiedValue[ uxIndex ] = ulValue;
+            break;
+        case eSetValueWithoutOverwrite:
+            if( ucOriginalState != simNOTIFY_RECEIVED )
+                pxTCB->ulNotifiedValue[ uxIndex ] = ulValue;
+            else
+                xReturn = pdFAIL;
+            break;
+        default:
+            break;
+    }
+
+    if( ucOriginalState == simNOTIFY_WAITING && pxTCB->eState == eBlocked &&
+            pxTCB->eWait == simWAIT_NOTIFY && pxTCB->uxWaitIndex == uxIndex )
+        prvMakeReady( pxTCB );
+
+    return xReturn;
+}
+
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                               uint32_t ulValue, eNotifyAction eAction,
+                               uint32_t *pulPreviousNotificationValue )
+{
+    BaseType_t xReturn;
+
+    xReturn = prvNotify( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue );
+    if( prvHigherThanCurrent( xTaskToNotify ) && xTaskToNotify->eState == eReady )
+        prvPreemptionPoint();
+
+    return xReturn;
+}
+
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                      uint32_t ulValue, eNotifyAction eAction,
+                                      uint32_t *pulPreviousNotificationValue,
+                                      BaseType_t *pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+
+    xReturn = prvNotify( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue );
+    if( pxHigherPriorityTaskWoken != NULL && xTaskToNotify->eState == eReady &&
+            prvHigherThanCurrent( xTaskToNotify ) )
+        *pxHigherPriorityTaskWoken = pdTRUE;
+
+    return xReturn;
+}
+
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                    BaseType_t *pxHigherPriorityTaskWoken )
+{
+    ( void ) xTaskGenericNotifyFromISR( xTaskToNotify, uxIndexToNotify, 0, eIncrement, NULL,
+                                        pxHigherPriorityTaskWoken );
+}
+
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit,
+                                  TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+    uint32_t ulReturn;
+
+    if( pxTCB->ulNotifiedValue[ uxIndexToWait ] == 0 && xTicksToWait > 0 )
+    {
+        pxTCB->ucNotifyState[ uxIndexToWait ] = simNOTIFY_WAITING;
+        prvBlock( simWAIT_NOTIFY, NULL, uxIndexToWait, xTicksToWait );
+    }
+
+    ulReturn = pxTCB->ulNotifiedValue[ uxIndexToWait ];
+    if( ulReturn != 0 )
+    {
+        if( xClearCountOnExit )
+            pxTCB->ulNotifiedValue[ uxIndexToWait ] = 0;
+        else
+            pxTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - 1;
+    }
+    pxTCB->ucNotifyState[ uxIndexToWait ] = simNOTIFY_NOT_WAITING;
+
+    return ulReturn;
+}
+
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry,
+                                   uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue,
+                                   TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+    BaseType_t xReturn;
+
+    if( pxTCB->ucNotifyState[ uxIndexToWait ] != simNOTIFY_RECEIVED )
+    {
+        pxTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
+        if( xTicksToWait > 0 )
+        {
+            pxTCB->ucNotifyState[ uxIndexToWait ] = simNOTIFY_WAITING;
+            prvBlock( simWAIT_NOTIFY, NULL, uxIndexToWait, xTicksToWait );
+        }
+    }
+
+    if( pulNotificationValue != NULL )
+        *pulNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToWait ];
+
+    if( pxTCB->ucNotifyState[ uxIndexToWait ] != simNOTIFY_RECEIVED )
+    {
+        xReturn = pdFALSE;
+    }
+    else
+    {
+        pxTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
+        xReturn = pdTRUE;
+    }
+    pxTCB->ucNotifyState[ uxIndexToWait ] = simNOTIFY_NOT_WAITING;
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+/* Queues and semaphores */
+
+static void prvQueueInit( struct QueueDefinition *pxQueue, UBaseType_t uxQueueLength,
+                          UBaseType_t uxItemSize, UBaseType_t uxInitialCount )
+{
+    pxQueue->uxLength = uxQueueLength;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->uxMessagesWaiting = uxInitialCount;
+    pxQueue->uxReadIndex = 0;
+}
+
+QueueHandle_t xQueueGenericCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                   UBaseType_t uxInitialCount )
+{
+    struct QueueDefinition *pxQueue;
+
+    pxQueue = calloc( 1, sizeof( *pxQueue ) );
+    if( pxQueue == NULL )
+        return NULL;
+
+    if( uxItemSize > 0 )
+    {
+        pxQueue->pucStorage = calloc( uxQueueLength, uxItemSize );
+        if( pxQueue->pucStorage == NULL )
+        {
+            free( pxQueue );
+            return NULL;
+        }
+    }
+
+    prvQueueInit( pxQueue, uxQueueLength, uxItemSize, uxInitialCount );
+    return pxQueue;
+}
+
+QueueHandle_t xQueueGenericCreateStatic( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                         uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                         UBaseType_t uxInitialCount )
+{
+    struct QueueDefinition *pxQueue;
+
+    if( pxStaticQueue == NULL || ( uxItemSize > 0 && pucQueueStorage == NULL ) )
+        return NULL;
+
+    /* The simulator bookkeeping is bigger than StaticQueue_t so it lives
+     * on the host heap, the item storage given by the caller is used */
+    pxQueue = calloc( 1, sizeof( *pxQueue ) );
+    if( pxQueue == NULL )
+        return NULL;
+
+    pxQueue->pucStorage = pucQueueStorage;
+    pxQueue->ucStaticStorage = 1;
+    prvQueueInit( pxQueue, uxQueueLength, uxItemSize, uxInitialCount );
+    return pxQueue;
+}
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+    if( xQueue == NULL )
+        return;
+    if( !xQueue->ucStaticStorage )
+        free( xQueue->pucStorage );
+    free( xQueue );
+}
+
+static BaseType_t prvQueueCopyIn( struct QueueDefinition *pxQueue, const void *pvItem )
+{
+    UBaseType_t uxWrite;
+
+    if( pxQueue->uxMessagesWaiting >= pxQueue->uxLength )
+        return pdFALSE;
+
+    if( pxQueue->uxItemSize > 0 )
+    {
+        uxWrite = ( pxQueue->uxReadIndex + pxQueue->uxMessagesWaiting ) % pxQueue->uxLength;
+        memcpy( pxQueue->pucStorage + uxWrite * pxQueue->uxItemSize, pvItem, pxQueue->uxItemSize );
+    }
+    pxQueue->uxMessagesWaiting++;
+
+    return pdTRUE;
+}
+
+static BaseType_t prvQueueCopyOut( struct QueueDefinition *pxQueue, void *pvBuffer )
+{
+    if( pxQueue->uxMessagesWaiting == 0 )
+        return pdFALSE;
+
+    if( pxQueue->uxItemSize > 0 )
+    {
+        if( pvBuffer != NULL )
+            memcpy( pvBuffer, pxQueue->pucStorage + pxQueue->uxReadIndex * pxQueue->uxItemSize,
+                    pxQueue->uxItemSize );
+        pxQueue->uxReadIndex = ( pxQueue->uxReadIndex + 1 ) % pxQueue->uxLength;
+    }
+    pxQueue->uxMessagesWaiting--;
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                              TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxWoken;
+
+    for( ;; )
+    {
+        if( prvQueueCopyIn( xQueue, pvItemToQueue ) )
+        {
+            pxWoken = prvWakeWaiter( simWAIT_QUEUE_RECEIVE, xQueue );
+            if( prvHigherThanCurrent( pxWoken ) )
+                prvPreemptionPoint();
+            return pdPASS;
+        }
+
+        if( xTicksToWait == 0 || !prvBlock( simWAIT_QUEUE_SEND, xQueue, 0, xTicksToWait ) )
+            return errQUEUE_FULL;
+    }
+}
+
+BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                     BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    struct tskTaskControlBlock *pxWoken;
+
+    if( !prvQueueCopyIn( xQueue, pvItemToQueue ) )
+        return errQUEUE_FULL;
+
+    pxWoken = prvWakeWaiter( simWAIT_QUEUE_RECEIVE, xQueue );
+    if( pxHigherPriorityTaskWoken != NULL && prvHigherThanCurrent( pxWoken ) )
+        *pxHigherPriorityTaskWoken = pdTRUE;
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxWoken;
+
+    for( ;; )
+    {
+        if( prvQueueCopyOut( xQueue, pvBuffer ) )
+        {
+            pxWoken = prvWakeWaiter( simWAIT_QUEUE_SEND, xQueue );
+            if( prvHigherThanCurrent( pxWoken ) )
+                prvPreemptionPoint();
+            return pdPASS;
+        }
+
+        if( xTicksToWait == 0 || !prvBlock( simWAIT_QUEUE_RECEIVE, xQueue, 0, xTicksToWait ) )
+            return errQUEUE_EMPTY;
+    }
+}
+
+BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer,
+                                 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    struct tskTaskControlBlock *pxWoken;
+
+    if( !prvQueueCopyOut( xQueue, pvBuffer ) )
+        return pdFAIL;
+
+    pxWoken = prvWakeWaiter( simWAIT_QUEUE_SEND, xQueue );
+    if( pxHigherPriorityTaskWoken != NULL && prvHigherThanCurrent( pxWoken ) )
+        *pxHigherPriorityTaskWoken = pdTRUE;
+
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t xQueue )
+{
+    return xQueue->uxMessagesWaiting;
+}
+
+BaseType_t xTaskGetSchedulerState( void ) { return xSchedulerRunning ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED; }
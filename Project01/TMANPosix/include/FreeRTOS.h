@@ -0,0 +1,264 @@
+/*
+ * POSIX kernel for the TMAN framework.
+ *
+ * Implements the subset of the FreeRTOS V202107.00 API used by tman.c on
+ * top of POSIX threads, in real time. Every task is a SCHED_FIFO thread at
+ * its FreeRTOS priority and the core affinity calls of the FreeRTOS SMP
+ * kernel pin threads to host CPUs, so a TMAN build with configNUM_CORES
+ * above 1 places its tasks on the cores of the host.
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOSConfig.h"
+
+/* Port types */
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define portMAX_DELAY                       ( ( TickType_t ) 0xffffffffUL )
+#define portTICK_PERIOD_MS                  ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portTICK_RATE_MS                    portTICK_PERIOD_MS
+#define portNOP()
+#define portBASE_TYPE                       long
+#define portSHORT                           short
+
+#define pdFALSE                             ( ( BaseType_t ) 0 )
+#define pdTRUE                              ( ( BaseType_t ) 1 )
+#define pdPASS                              ( pdTRUE )
+#define pdFAIL                              ( pdFALSE )
+#define errQUEUE_EMPTY                      ( ( BaseType_t ) 0 )
+#define errQUEUE_FULL                       ( ( BaseType_t ) 0 )
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY   ( -1 )
+
+#define tskIDLE_PRIORITY                    ( ( UBaseType_t ) 0U )
+
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+    #define configTASK_NOTIFICATION_ARRAY_ENTRIES   1
+#endif
+#ifndef configNUM_THREAD_LOCAL_STORAGE_POINTERS
+    #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 0
+#endif
+#ifndef configSUPPORT_STATIC_ALLOCATION
+    #define configSUPPORT_STATIC_ALLOCATION     0
+#endif
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+    #define configSUPPORT_DYNAMIC_ALLOCATION    1
+#endif
+#ifndef configUSE_TICK_HOOK
+    #define configUSE_TICK_HOOK                 0
+#endif
+#ifndef configNUM_CORES
+    #define configNUM_CORES                     1
+#endif
+#ifndef configUSE_CORE_AFFINITY
+    #define configUSE_CORE_AFFINITY             0
+#endif
+
+/* Opaque kernel objects */
+struct tskTaskControlBlock;
+typedef struct tskTaskControlBlock * TaskHandle_t;
+struct QueueDefinition;
+typedef struct QueueDefinition * QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef void (*TaskFunction_t)( void * );
+
+/* Storage for statically allocated objects. The kernel keeps its own
+ * bookkeeping so these only need to exist with a plausible size. */
+typedef struct xSTATIC_TCB { void *pvDummy[ 24 ]; } StaticTask_t;
+typedef struct xSTATIC_QUEUE { void *pvDummy[ 20 ]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+typedef enum
+{
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+/* Critical sections: one recursive kernel lock, taken by the critical
+ * sections, the scheduler suspension and the FromISR masks alike. There are
+ * no interrupts, a task holding the lock only keeps the others out of the
+ * kernel and of the framework state. */
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+UBaseType_t uxPortSetInterruptMaskFromISR( void );
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSaved );
+void vPortYieldFromISR( BaseType_t xSwitchRequired );
+
+#define taskENTER_CRITICAL()                vPortEnterCritical()
+#define taskEXIT_CRITICAL()                 vPortExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR()       uxPortSetInterruptMaskFromISR()
+#define taskEXIT_CRITICAL_FROM_ISR( x )     vPortClearInterruptMaskFromISR( x )
+#define portSET_INTERRUPT_MASK_FROM_ISR()   uxPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )  vPortClearInterruptMaskFromISR( x )
+#define taskDISABLE_INTERRUPTS()            vPortEnterCritical()
+#define taskENABLE_INTERRUPTS()             vPortExitCritical()
+#define portDISABLE_INTERRUPTS()            vPortEnterCritical()
+#define portENABLE_INTERRUPTS()             vPortExitCritical()
+#define portEND_SWITCHING_ISR( x )          vPortYieldFromISR( x )
+#define portYIELD_FROM_ISR( x )             vPortYieldFromISR( x )
+#define taskYIELD()                         vTaskYield()
+
+/* Tasks */
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName,
+                        uint32_t usStackDepth, void * const pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask );
+TaskHandle_t xTaskCreateStatic( TaskFunction_t pxTaskCode, const char * const pcName,
+                                uint32_t ulStackDepth, void * const pvParameters,
+                                UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                                StaticTask_t * const pxTaskBuffer );
+void vTaskDelete( TaskHandle_t xTaskToDelete );
+void vTaskDelay( TickType_t xTicksToDelay );
+void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement );
+BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement );
+BaseType_t xTaskAbortDelay( TaskHandle_t xTask );
+TickType_t xTaskGetTickCount( void );
+TickType_t xTaskGetTickCountFromISR( void );
+TaskHandle_t xTaskGetCurrentTaskHandle( void );
+char * pcTaskGetName( TaskHandle_t xTaskToQuery );
+void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue );
+void * pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex );
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority );
+UBaseType_t uxTaskPriorityGet( TaskHandle_t xTask );
+UBaseType_t uxTaskPriorityGetFromISR( TaskHandle_t xTask );
+void vTaskSuspendAll( void );
+#define taskSCHEDULER_SUSPENDED 0
+#define taskSCHEDULER_NOT_STARTED 1
+#define taskSCHEDULER_RUNNING 2
+BaseType_t xTaskGetSchedulerState( void );
+BaseType_t xTaskResumeAll( void );
+/* eRunning for every task neither blocked nor deleted, the host does not
+ * tell a running thread from a preempted one */
+eTaskState eTaskGetState( TaskHandle_t xTask );
+void vTaskYield( void );
+void vTaskStartScheduler( void );
+void vTaskEndScheduler( void );
+
+/* Core affinity of the FreeRTOS SMP kernel, bit n of the mask is core n */
+#define tskNO_AFFINITY                      ( ( UBaseType_t ) -1 )
+#if( configNUM_CORES > 1 && configUSE_CORE_AFFINITY == 1 )
+void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );
+UBaseType_t vTaskCoreAffinityGet( const TaskHandle_t xTask );
+#endif
+
+/* Direct to task notifications */
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                               uint32_t ulValue, eNotifyAction eAction,
+                               uint32_t *pulPreviousNotificationValue );
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                      uint32_t ulValue, eNotifyAction eAction,
+                                      uint32_t *pulPreviousNotificationValue,
+                                      BaseType_t *pxHigherPriorityTaskWoken );
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                    BaseType_t *pxHigherPriorityTaskWoken );
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit,
+                                  TickType_t xTicksToWait );
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry,
+                                   uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue,
+                                   TickType_t xTicksToWait );
+
+#define xTaskNotifyGiveIndexed( xTask, uxIndex ) \
+    xTaskGenericNotify( ( xTask ), ( uxIndex ), 0, eIncrement, NULL )
+#define xTaskNotifyGive( xTask ) xTaskNotifyGiveIndexed( ( xTask ), 0 )
+#define vTaskNotifyGiveIndexedFromISR( xTask, uxIndex, pxWoken ) \
+    vTaskGenericNotifyGiveFromISR( ( xTask ), ( uxIndex ), ( pxWoken ) )
+#define vTaskNotifyGiveFromISR( xTask, pxWoken ) vTaskNotifyGiveIndexedFromISR( ( xTask ), 0, ( pxWoken ) )
+#define ulTaskNotifyTakeIndexed( uxIndex, xClear, xTicks ) \
+    ulTaskGenericNotifyTake( ( uxIndex ), ( xClear ), ( xTicks ) )
+#define ulTaskNotifyTake( xClear, xTicks ) ulTaskNotifyTakeIndexed( 0, ( xClear ), ( xTicks ) )
+#define xTaskNotifyIndexed( xTask, uxIndex, ulValue, eAction ) \
+    xTaskGenericNotify( ( xTask ), ( uxIndex ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotify( xTask, ulValue, eAction ) xTaskNotifyIndexed( ( xTask ), 0, ( ulValue ), ( eAction ) )
+#define xTaskNotifyIndexedFromISR( xTask, uxIndex, ulValue, eAction, pxWoken ) \
+    xTaskGenericNotifyFromISR( ( xTask ), ( uxIndex ), ( ulValue ), ( eAction ), NULL, ( pxWoken ) )
+#define xTaskNotifyFromISR( xTask, ulValue, eAction, pxWoken ) \
+    xTaskNotifyIndexedFromISR( ( xTask ), 0, ( ulValue ), ( eAction ), ( pxWoken ) )
+#define xTaskNotifyWaitIndexed( uxIndex, ulEntry, ulExit, pulValue, xTicks ) \
+    xTaskGenericNotifyWait( ( uxIndex ), ( ulEntry ), ( ulExit ), ( pulValue ), ( xTicks ) )
+#define xTaskNotifyWait( ulEntry, ulExit, pulValue, xTicks ) \
+    xTaskNotifyWaitIndexed( 0, ( ulEntry ), ( ulExit ), ( pulValue ), ( xTicks ) )
+
+/* Queues and semaphores */
+QueueHandle_t xQueueGenericCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                   UBaseType_t uxInitialCount );
+QueueHandle_t xQueueGenericCreateStatic( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                         uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                         UBaseType_t uxInitialCount );
+void vQueueDelete( QueueHandle_t xQueue );
+BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                              TickType_t xTicksToWait );
+BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                     BaseType_t * const pxHigherPriorityTaskWoken );
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait );
+BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer,
+                                 BaseType_t * const pxHigherPriorityTaskWoken );
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t xQueue );
+
+#define xQueueCreate( uxLength, uxSize )    xQueueGenericCreate( ( uxLength ), ( uxSize ), 0 )
+#define xQueueCreateStatic( uxLength, uxSize, pucStorage, pxBuffer ) \
+    xQueueGenericCreateStatic( ( uxLength ), ( uxSize ), ( pucStorage ), ( pxBuffer ), 0 )
+#define xQueueSend( xQueue, pvItem, xTicks )        xQueueGenericSend( ( xQueue ), ( pvItem ), ( xTicks ) )
+#define xQueueSendToBack( xQueue, pvItem, xTicks )  xQueueGenericSend( ( xQueue ), ( pvItem ), ( xTicks ) )
+#define xQueueSendFromISR( xQueue, pvItem, pxWoken ) \
+    xQueueGenericSendFromISR( ( xQueue ), ( pvItem ), ( pxWoken ) )
+#define xQueueSendToBackFromISR( xQueue, pvItem, pxWoken ) \
+    xQueueGenericSendFromISR( ( xQueue ), ( pvItem ), ( pxWoken ) )
+
+#define xSemaphoreCreateBinary()            xQueueGenericCreate( 1, 0, 0 )
+#define xSemaphoreCreateBinaryStatic( pxBuffer ) \
+    xQueueGenericCreateStatic( 1, 0, NULL, ( pxBuffer ), 0 )
+#define xSemaphoreCreateCounting( uxMax, uxInitial ) \
+    xQueueGenericCreate( ( uxMax ), 0, ( uxInitial ) )
+#define xSemaphoreCreateCountingStatic( uxMax, uxInitial, pxBuffer ) \
+    xQueueGenericCreateStatic( ( uxMax ), 0, NULL, ( pxBuffer ), ( uxInitial ) )
+#define xSemaphoreGive( xSemaphore )        xQueueGenericSend( ( xSemaphore ), NULL, 0 )
+#define xSemaphoreGiveFromISR( xSemaphore, pxWoken ) \
+    xQueueGenericSendFromISR( ( xSemaphore ), NULL, ( pxWoken ) )
+#define xSemaphoreTake( xSemaphore, xTicks ) xQueueReceive( ( xSemaphore ), NULL, ( xTicks ) )
+#define xSemaphoreTakeFromISR( xSemaphore, pxWoken ) \
+    xQueueReceiveFromISR( ( xSemaphore ), NULL, ( pxWoken ) )
+#define vSemaphoreDelete( xSemaphore )      vQueueDelete( ( QueueHandle_t ) ( xSemaphore ) )
+
+/* Heap */
+void *pvPortMalloc( size_t xSize );
+void vPortFree( void *pv );
+size_t xPortGetFreeHeapSize( void );
+
+/* Application hooks */
+void vApplicationTickHook( void );
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer,
+                                    StackType_t **ppxIdleTaskStackBuffer,
+                                    uint32_t *pulIdleTaskStackSize );
+#endif
+
+/* Port control, not part of the FreeRTOS API */
+
+/* Core timer frequency, the PIC32 CP0 Count runs at half the CPU clock */
+#define portCORE_TIMER_HZ                   ( configCPU_CLOCK_HZ / 2UL )
+
+/* vTaskStartScheduler returns once the tick count reaches xEndTick */
+void vPortSetEndTick( TickType_t xEndTick );
+/* CLOCK_MONOTONIC scaled to the core timer frequency */
+uint32_t ulPortGetCoreTimer( void );
+
+#endif /* INC_FREERTOS_H */
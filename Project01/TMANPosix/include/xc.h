@@ -0,0 +1,17 @@
+/*
+ * POSIX stand-in for the XC32 device header.
+ */
+
+#ifndef POSIX_XC_H
+#define POSIX_XC_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+
+/* CP0 Count register, read from the host monotonic clock. There is no
+ * Timer2, TMAN_TIME_SOURCE_TIMER is not available on this port */
+#define _CP0_GET_COUNT()        ulPortGetCoreTimer()
+
+#define __attribute__( x )
+
+#endif /* POSIX_XC_H */
@@ -0,0 +1,167 @@
+/*
+ * POSIX build of the TMAN demo
+ * - Runs the task set of mainTMAN.c, with WCETs, on the POSIX kernel in real
+ *   time and prints the same "name, tick" lines the board sends to the UART
+ * - On a build with configNUM_CORES above 1 the admission test places every
+ *   task on a core of the host and the statistics tell which one
+ *
+ * Usage: tmanposix [hyperperiods] [-q]
+ * - hyperperiods: number of hyperperiods to run, 10 by default
+ * - -q: do not print the job lines, only the final statistics
+ *
+ * Build with EXTRA="-DTMAN_PARTITION=1" to spread the tasks over the cores
+ * instead of packing them, and CORES=n to build for n cores
+ *
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <xc.h>
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+/* App includes */
+#include "../UART/uart.h"
+#include "tman.h"
+#include "tmantaskset.h"
+
+/* Framework configuration parameters */
+#define TMAN_TICK                   10
+#define TMAN_NUMBER_TASK            6
+/* Hyperperiod of the task set in TMAN ticks */
+#define TMAN_HYPERPERIOD            9
+/* CPU time of each job, in percent of the WCET of its task */
+#ifndef JOB_PERCENT
+#define JOB_PERCENT                 60
+#endif
+
+void defaultTask( void *pvParam );
+
+/* Task set of mainTMAN.c with WCETs in us, utilization 0.6 */
+#define DEMO_TASKS( X ) \
+    X( A, 1, 0, 0, 1500, NONE, tskIDLE_PRIORITY + 3, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( B, 1, 0, 0, 1500, NONE, tskIDLE_PRIORITY + 3, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( C, 3, 0, 0, 3000, NONE, tskIDLE_PRIORITY + 2, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( D, 3, 1, 0, 3000, NONE, tskIDLE_PRIORITY + 2, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( E, 9, 2, 0, 4500, D,    tskIDLE_PRIORITY + 1, defaultTask, configMINIMAL_STACK_SIZE ) \
+    X( F, 9, 3, 0, 4500, NONE, tskIDLE_PRIORITY + 1, defaultTask, configMINIMAL_STACK_SIZE )
+
+/* Task table of the set, see tmantaskset.h */
+TMAN_TASKSET_DEFINE( demoTaskSet, DEMO_TASKS, TMAN_TICK * 1000UL );
+
+/* Job lines are not printed when set */
+static uint32_t g_quiet = 0;
+
+void vApplicationTickHook( void )
+{
+}
+
+/* CPU time of the calling thread in microseconds */
+static uint64_t prvThreadCpuUs( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &now );
+    return ( uint64_t ) now.tv_sec * 1000000ULL + ( uint64_t ) now.tv_nsec / 1000ULL;
+}
+
+void defaultTask( void *pvParam )
+{
+    TickType_t tick;
+    uint32_t i, err, jobUs = 0;
+    uint64_t start;
+    uint8_t mesg[80];
+
+    /* The job length follows the WCET of the task */
+    for( i = 0; i < TMAN_NUMBER_TASK; i++ )
+    {
+        if( strcmp( demoTaskSet[i].pcName, ( char * ) pvParam ) == 0 )
+            jobUs = demoTaskSet[i].wcetUs * JOB_PERCENT / 100;
+    }
+
+    for(;;)
+    {
+        err = TMAN_TaskWaitPeriodSelf();
+
+        if( err )
+            exit(err);
+
+        if( !g_quiet )
+        {
+            tick = xTaskGetTickCount();
+
+            sprintf( ( char * ) mesg, "%s, %u\n", (char *) pvParam, (uint32_t) tick );
+            PrintStr( mesg );
+        }
+
+        /* Stands in for the busy loop of the board demo, in CPU time so
+         * preemption does not shorten the job */
+        start = prvThreadCpuUs();
+        while( prvThreadCpuUs() - start < jobUs );
+    }
+}
+
+int main( int argc, char **argv )
+{
+    /* Iteration variable and error code */
+    uint32_t i, err;
+    /* Number of hyperperiods to run */
+    uint32_t hyperperiods = 10;
+
+    for( i = 1; i < ( uint32_t ) argc; i++ )
+    {
+        if( strcmp( argv[i], "-q" ) == 0 )
+            g_quiet = 1;
+        else
+            hyperperiods = ( uint32_t ) strtoul( argv[i], NULL, 10 );
+    }
+
+    /* The tick count is 32 bits wide, stop before it wraps */
+    if( hyperperiods == 0 ||
+            hyperperiods > 0xFFFFFFFFUL / ( TMAN_HYPERPERIOD * TMAN_TICK ) )
+    {
+        fprintf( stderr, "usage: %s [hyperperiods] [-q]\n", argv[0] );
+        return 1;
+    }
+    vPortSetEndTick( hyperperiods * TMAN_HYPERPERIOD * TMAN_TICK );
+
+    /* Initialize framework */
+    err = TMAN_Init( TMAN_TICK, 0, NULL );
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+    /* Add the task set and create its tasks */
+    err = TMAN_TASKSET_LOAD( demoTaskSet );
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+    /* Build the release table and place the tasks on the cores */
+    err = TMAN_Start();
+    /* Exit program in case function returns an error code */
+    if( err )
+    {
+        printf("error: %d\n", err);
+        exit(err);
+    }
+
+    /* Returns at the end tick, with the tasks held off */
+    vTaskStartScheduler();
+
+    for( i = 0; i < TMAN_NUMBER_TASK; i++ )
+        TMAN_TaskStats( demoTaskSet[i].pcName );
+
+    TMAN_Close();
+
+    return 0;
+}
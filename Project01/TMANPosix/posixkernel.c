@@ -0,0 +1,1130 @@
+/*
+ * POSIX kernel for the TMAN framework.
+ *
+ * Every FreeRTOS task is a POSIX thread. Threads run under SCHED_FIFO at
+ * configPOSIX_PRIORITY_BASE plus their FreeRTOS priority, so the host
+ * scheduler applies the fixed priority preemption and the FIFO order
+ * inside a priority the framework depends on. Without the permission to
+ * use SCHED_FIFO the threads run under the default policy, with a warning,
+ * which keeps the port usable for functional runs.
+ *
+ * The kernel state, the critical sections and the framework state share one
+ * recursive lock. A task only blocks with the lock released, on a condition
+ * variable of its own, and delays are timed waits on it to an absolute tick
+ * boundary of CLOCK_MONOTONIC, so periodic releases do not drift and
+ * xTaskAbortDelay can end them.
+ *
+ * Core n of the SMP affinity API is the n-th CPU the process may run on.
+ */
+
+#define _GNU_SOURCE                 /* pthread_setaffinity_np, CPU_SET */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <xc.h>
+#include "../UART/uart.h"
+
+#define posixSTACK_SIZE             ( 256 * 1024 )
+#define posixNS_PER_SEC             ( 1000000000LL )
+#define posixTICK_NS                ( posixNS_PER_SEC / configTICK_RATE_HZ )
+
+typedef enum
+{
+    posixWAIT_NONE = 0,
+    posixWAIT_DELAY,
+    posixWAIT_QUEUE_RECEIVE,
+    posixWAIT_QUEUE_SEND,
+    posixWAIT_NOTIFY
+} PosixWait_t;
+
+struct tskTaskControlBlock
+{
+    pthread_t xThread;
+    /* Signalled when a blocked task is woken or deleted */
+    pthread_cond_t xWake;
+    char pcName[ configMAX_TASK_NAME_LEN ];
+    UBaseType_t uxPriority;
+    UBaseType_t uxCoreAffinityMask;
+    eTaskState eState;
+    /* Set by vTaskDelete from another task, the thread exits at its next
+     * call into the kernel */
+    BaseType_t xDeletePending;
+    /* Order inside the waiting list of a kernel object */
+    uint64_t ullBlockSeq;
+    PosixWait_t eWait;
+    void *pvWaitObject;
+    UBaseType_t uxWaitIndex;
+    BaseType_t xWoken;
+    /* Set by xTaskAbortDelay, ends the block as a timeout */
+    BaseType_t xAborted;
+    uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+    uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
+    void *pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
+#endif
+    TaskFunction_t pxTaskCode;
+    void *pvParameters;
+    struct tskTaskControlBlock *pxNext;
+};
+
+struct QueueDefinition
+{
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    UBaseType_t uxMessagesWaiting;
+    UBaseType_t uxReadIndex;
+    uint8_t *pucStorage;
+    uint8_t ucStaticStorage;
+};
+
+/* Kernel state, guarded by xKernelLock */
+static pthread_once_t xInitOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t xKernelLock;
+static pthread_cond_t xStartCond;
+static pthread_cond_t xEndCond;
+static struct tskTaskControlBlock *pxTaskList = NULL;
+static uint64_t ullSeq = 0;
+static uint64_t ullEndTick = 0;
+static BaseType_t xSchedulerRunning = pdFALSE;
+static BaseType_t xEndRequested = pdFALSE;
+static BaseType_t xRealTime = pdTRUE;
+/* Tick 0 of the tick count, on CLOCK_MONOTONIC */
+static int64_t llEpochNs = 0;
+
+/* Host CPU of every core */
+static int lCoreCpu[ configNUM_CORES ];
+
+/* Task of the calling thread, NULL on the main thread */
+static __thread struct tskTaskControlBlock *pxCurrentTCB = NULL;
+/* Nesting of the kernel lock held by the calling thread */
+static __thread UBaseType_t uxLockNesting = 0;
+
+void vAssertCalled( const char *pcFileName, unsigned long ulLine )
+{
+    fprintf( stderr, "assert failed: %s:%lu\n", pcFileName, ulLine );
+    abort();
+}
+
+void *pvPortMalloc( size_t xSize )
+{
+    return malloc( xSize );
+}
+
+void vPortFree( void *pv )
+{
+    free( pv );
+}
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return configTOTAL_HEAP_SIZE;
+}
+
+int UartInit( uint64_t pbclock, uint32_t br )
+{
+    ( void ) pbclock;
+    ( void ) br;
+    return UART_SUCCESS;
+}
+
+void PrintStr( uint8_t *txStr )
+{
+    fputs( ( const char * ) txStr, stdout );
+}
+
+/*-----------------------------------------------------------*/
+
+static int64_t prvNowNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( int64_t ) xNow.tv_sec * posixNS_PER_SEC + xNow.tv_nsec;
+}
+
+static struct timespec prvTimespec( int64_t llNs )
+{
+    struct timespec xTime;
+
+    xTime.tv_sec = ( time_t ) ( llNs / posixNS_PER_SEC );
+    xTime.tv_nsec = ( long ) ( llNs % posixNS_PER_SEC );
+    return xTime;
+}
+
+static uint64_t prvTickCount( void )
+{
+    if( !xSchedulerRunning )
+        return 0;
+    return ( uint64_t ) ( prvNowNs() - llEpochNs ) / posixTICK_NS;
+}
+
+static void prvInit( void )
+{
+    pthread_mutexattr_t xMutexAttr;
+    pthread_condattr_t xCondAttr;
+    cpu_set_t xCpus;
+    int lCpu, lCount = 0;
+    UBaseType_t uxCore;
+
+    /* Priority inheritance keeps a preempted lock holder from stalling the
+     * higher priority tasks */
+    pthread_mutexattr_init( &xMutexAttr );
+    pthread_mutexattr_settype( &xMutexAttr, PTHREAD_MUTEX_RECURSIVE );
+    pthread_mutexattr_setprotocol( &xMutexAttr, PTHREAD_PRIO_INHERIT );
+    pthread_mutex_init( &xKernelLock, &xMutexAttr );
+    pthread_mutexattr_destroy( &xMutexAttr );
+
+    pthread_condattr_init( &xCondAttr );
+    pthread_condattr_setclock( &xCondAttr, CLOCK_MONOTONIC );
+    pthread_cond_init( &xStartCond, &xCondAttr );
+    pthread_cond_init( &xEndCond, &xCondAttr );
+    pthread_condattr_destroy( &xCondAttr );
+
+    /* Cores map onto the CPUs the process may use, in order */
+    CPU_ZERO( &xCpus );
+    if( sched_getaffinity( 0, sizeof( xCpus ), &xCpus ) == 0 )
+    {
+        for( lCpu = 0; lCpu < CPU_SETSIZE && lCount < configNUM_CORES; lCpu++ )
+        {
+            if( CPU_ISSET( lCpu, &xCpus ) )
+                lCoreCpu[ lCount++ ] = lCpu;
+        }
+    }
+
+    if( lCount == 0 )
+        lCoreCpu[ lCount++ ] = 0;
+
+    if( lCount < configNUM_CORES )
+        fprintf( stderr, "posix kernel: %d cores on %d CPUs, cores share CPUs\n",
+                 configNUM_CORES, lCount );
+
+    for( uxCore = lCount; uxCore < configNUM_CORES; uxCore++ )
+        lCoreCpu[ uxCore ] = lCoreCpu[ uxCore % lCount ];
+}
+
+/* Exit the calling thread, its task was deleted */
+static void prvExitThread( struct tskTaskControlBlock *pxTCB )
+{
+    pxTCB->eState = eDeleted;
+    while( uxLockNesting > 0 )
+    {
+        uxLockNesting--;
+        pthread_mutex_unlock( &xKernelLock );
+    }
+
+    /* The control block is leaked on purpose, handles to it may remain */
+    pthread_exit( NULL );
+}
+
+static void prvLock( void )
+{
+    pthread_once( &xInitOnce, prvInit );
+    pthread_mutex_lock( &xKernelLock );
+    uxLockNesting++;
+}
+
+static void prvUnlock( void )
+{
+    configASSERT( uxLockNesting > 0 );
+
+    /* Leaving the kernel is the deletion point of a task deleted by another */
+    if( uxLockNesting == 1 && pxCurrentTCB != NULL && pxCurrentTCB->xDeletePending )
+        prvExitThread( pxCurrentTCB );
+
+    uxLockNesting--;
+    pthread_mutex_unlock( &xKernelLock );
+}
+
+static struct tskTaskControlBlock * prvGetTCB( TaskHandle_t xTask )
+{
+    return ( xTask == NULL ) ? pxCurrentTCB : xTask;
+}
+
+/* Absolute CLOCK_MONOTONIC time of a timeout in ticks, from now */
+static int64_t prvTimeout( TickType_t xTicksToWait )
+{
+    return prvNowNs() + ( int64_t ) xTicksToWait * posixTICK_NS;
+}
+
+/* Block the calling task, kernel lock held once; returns pdFALSE when the
+ * block timed out. A deadline of 0 waits forever */
+static BaseType_t prvBlock( PosixWait_t eWait, void *pvObject, UBaseType_t uxIndex, int64_t llDeadlineNs )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+    struct timespec xDeadline = prvTimespec( llDeadlineNs );
+
+    /* A nested critical section would block with the lock still held */
+    configASSERT( pxTCB != NULL && uxLockNesting == 1 );
+
+    pxTCB->eState = eBlocked;
+    pxTCB->eWait = eWait;
+    pxTCB->pvWaitObject = pvObject;
+    pxTCB->uxWaitIndex = uxIndex;
+    pxTCB->ullBlockSeq = ++ullSeq;
+    pxTCB->xWoken = pdFALSE;
+    pxTCB->xAborted = pdFALSE;
+
+    while( !pxTCB->xWoken && !pxTCB->xAborted && !pxTCB->xDeletePending )
+    {
+        if( llDeadlineNs == 0 )
+            pthread_cond_wait( &pxTCB->xWake, &xKernelLock );
+        else if( pthread_cond_timedwait( &pxTCB->xWake, &xKernelLock, &xDeadline ) == ETIMEDOUT )
+            break;
+    }
+
+    pxTCB->eState = eReady;
+    pxTCB->eWait = posixWAIT_NONE;
+    pxTCB->pvWaitObject = NULL;
+
+    if( pxTCB->xDeletePending )
+        prvExitThread( pxTCB );
+
+    return pxTCB->xWoken;
+}
+
+static void prvMakeReady( struct tskTaskControlBlock *pxTCB )
+{
+    pxTCB->xWoken = pdTRUE;
+    pxTCB->eState = eReady;
+    pthread_cond_signal( &pxTCB->xWake );
+}
+
+/* Wake the highest priority task waiting on an object */
+static void prvWakeWaiter( PosixWait_t eWait, void *pvObject )
+{
+    struct tskTaskControlBlock *pxTCB, *pxBest = NULL;
+
+    for( pxTCB = pxTaskList; pxTCB != NULL; pxTCB = pxTCB->pxNext )
+    {
+        if( pxTCB->eState != eBlocked || pxTCB->eWait != eWait || pxTCB->pvWaitObject != pvObject )
+            continue;
+        if( pxBest == NULL || pxTCB->uxPriority > pxBest->uxPriority ||
+                ( pxTCB->uxPriority == pxBest->uxPriority && pxTCB->ullBlockSeq < pxBest->ullBlockSeq ) )
+            pxBest = pxTCB;
+    }
+
+    if( pxBest != NULL )
+        prvMakeReady( pxBest );
+}
+
+/* Sleep the calling task to an absolute tick, xTaskAbortDelay ends it early */
+static void prvSleepUntilTick( uint64_t ullTick )
+{
+    configASSERT( pxCurrentTCB != NULL && uxLockNesting == 0 );
+
+    prvLock();
+    ( void ) prvBlock( posixWAIT_DELAY, NULL, 0, llEpochNs + ( int64_t ) ullTick * posixTICK_NS );
+    prvUnlock();
+}
+
+/*-----------------------------------------------------------*/
+/* Time */
+
+uint32_t ulPortGetCoreTimer( void )
+{
+    uint64_t ullNs = ( uint64_t ) prvNowNs();
+
+    /* Split so the product does not overflow */
+    return ( uint32_t ) ( ( ullNs / posixNS_PER_SEC ) * portCORE_TIMER_HZ +
+                          ( ullNs % posixNS_PER_SEC ) * portCORE_TIMER_HZ / posixNS_PER_SEC );
+}
+
+void vPortSetEndTick( TickType_t xEndTick )
+{
+    ullEndTick = xEndTick;
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+    return ( TickType_t ) prvTickCount();
+}
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+    return ( TickType_t ) prvTickCount();
+}
+
+void vTaskDelay( TickType_t xTicksToDelay )
+{
+    /* FreeRTOS wakes a delayed task on a tick interrupt */
+    if( xTicksToDelay > 0 )
+        prvSleepUntilTick( prvTickCount() + xTicksToDelay );
+}
+
+BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement )
+{
+    uint64_t ullNow = prvTickCount();
+    TickType_t xNow = ( TickType_t ) ullNow;
+    TickType_t xWake = *pxPreviousWakeTime + xTimeIncrement;
+    BaseType_t xShouldDelay;
+
+    /* Same wrap handling as tasks.c */
+    if( xNow < *pxPreviousWakeTime )
+        xShouldDelay = ( xWake < *pxPreviousWakeTime && xWake > xNow ) ? pdTRUE : pdFALSE;
+    else
+        xShouldDelay = ( xWake < *pxPreviousWakeTime || xWake > xNow ) ? pdTRUE : pdFALSE;
+
+    *pxPreviousWakeTime = xWake;
+
+    if( xShouldDelay )
+        prvSleepUntilTick( ullNow + ( TickType_t ) ( xWake - xNow ) );
+
+    return xShouldDelay;
+}
+
+void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, TickType_t xTimeIncrement )
+{
+    ( void ) xTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement );
+}
+
+BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+{
+    struct tskTaskControlBlock *pxTCB;
+    BaseType_t xReturn = pdFAIL;
+
+    prvLock();
+    pxTCB = prvGetTCB( xTask );
+    if( pxTCB->eState == eBlocked )
+    {
+        pxTCB->xAborted = pdTRUE;
+        pthread_cond_signal( &pxTCB->xWake );
+        xReturn = pdPASS;
+    }
+    prvUnlock();
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+/* Critical sections */
+
+void vPortEnterCritical( void )
+{
+    prvLock();
+}
+
+void vPortExitCritical( void )
+{
+    prvUnlock();
+}
+
+UBaseType_t uxPortSetInterruptMaskFromISR( void )
+{
+    prvLock();
+    return 0;
+}
+
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSaved )
+{
+    ( void ) uxSaved;
+    prvUnlock();
+}
+
+void vPortYieldFromISR( BaseType_t xSwitchRequired )
+{
+    /* The host scheduler preempts as soon as a thread is woken */
+    ( void ) xSwitchRequired;
+}
+
+void vTaskSuspendAll( void )
+{
+    prvLock();
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+    prvUnlock();
+    return pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+/* Tasks */
+
+static int prvFifoPriority( UBaseType_t uxPriority )
+{
+    int lPriority = configPOSIX_PRIORITY_BASE + ( int ) uxPriority;
+
+    if( lPriority > sched_get_priority_max( SCHED_FIFO ) )
+        lPriority = sched_get_priority_max( SCHED_FIFO );
+    return lPriority;
+}
+
+#if( configNUM_CORES > 1 && configUSE_CORE_AFFINITY == 1 )
+/* Apply the affinity mask of a task to its thread */
+static void prvApplyAffinity( struct tskTaskControlBlock *pxTCB )
+{
+    static BaseType_t xWarned = pdFALSE;
+    cpu_set_t xCpus;
+    UBaseType_t uxCore;
+
+    if( pxTCB->uxCoreAffinityMask == tskNO_AFFINITY )
+    {
+        if( sched_getaffinity( 0, sizeof( xCpus ), &xCpus ) != 0 )
+            return;
+    }
+    else
+    {
+        CPU_ZERO( &xCpus );
+        for( uxCore = 0; uxCore < configNUM_CORES; uxCore++ )
+        {
+            if( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1 << uxCore ) )
+                CPU_SET( lCoreCpu[ uxCore ], &xCpus );
+        }
+    }
+
+    if( pthread_setaffinity_np( pxTCB->xThread, sizeof( xCpus ), &xCpus ) != 0 && !xWarned )
+    {
+        xWarned = pdTRUE;
+        fprintf( stderr, "posix kernel: can not pin %s, tasks run on any CPU\n", pxTCB->pcName );
+    }
+}
+#endif
+
+static void *prvTaskEntry( void *pvArg )
+{
+    struct tskTaskControlBlock *pxTCB = pvArg;
+
+    pxCurrentTCB = pxTCB;
+
+    /* Tasks created before the scheduler starts wait for it */
+    prvLock();
+    while( !xSchedulerRunning && !pxTCB->xDeletePending )
+        pthread_cond_wait( &xStartCond, &xKernelLock );
+    prvUnlock();
+
+    pxTCB->pxTaskCode( pxTCB->pvParameters );
+
+    /* FreeRTOS tasks must never return */
+    configASSERT( 0 );
+    return NULL;
+}
+
+static int prvStartThread( struct tskTaskControlBlock *pxTCB )
+{
+    static BaseType_t xWarned = pdFALSE;
+    pthread_attr_t xAttr;
+    struct sched_param xParam;
+    int lError;
+
+    pthread_attr_init( &xAttr );
+    pthread_attr_setstacksize( &xAttr, posixSTACK_SIZE );
+    pthread_attr_setdetachstate( &xAttr, PTHREAD_CREATE_DETACHED );
+
+    if( xRealTime )
+    {
+        memset( &xParam, 0, sizeof( xParam ) );
+        xParam.sched_priority = prvFifoPriority( pxTCB->uxPriority );
+        pthread_attr_setinheritsched( &xAttr, PTHREAD_EXPLICIT_SCHED );
+        pthread_attr_setschedpolicy( &xAttr, SCHED_FIFO );
+        pthread_attr_setschedparam( &xAttr, &xParam );
+    }
+
+    lError = pthread_create( &pxTCB->xThread, &xAttr, prvTaskEntry, pxTCB );
+    pthread_attr_destroy( &xAttr );
+
+    /* No permission to use SCHED_FIFO, fall back to the default policy */
+    if( lError == EPERM && xRealTime )
+    {
+        xRealTime = pdFALSE;
+        if( !xWarned )
+        {
+            xWarned = pdTRUE;
+            fprintf( stderr, "posix kernel: SCHED_FIFO not permitted, priorities are not enforced\n" );
+        }
+        return prvStartThread( pxTCB );
+    }
+
+    return lError;
+}
+
+static TaskHandle_t prvCreateTask( TaskFunction_t pxTaskCode, const char * const pcName,
+                                   void * const pvParameters, UBaseType_t uxPriority )
+{
+    struct tskTaskControlBlock *pxTCB, **ppxTail;
+    pthread_condattr_t xCondAttr;
+
+    pxTCB = calloc( 1, sizeof( *pxTCB ) );
+    if( pxTCB == NULL )
+        return NULL;
+
+    strncpy( pxTCB->pcName, pcName, configMAX_TASK_NAME_LEN - 1 );
+    if( uxPriority >= configMAX_PRIORITIES )
+        uxPriority = configMAX_PRIORITIES - 1;
+    pxTCB->uxPriority = uxPriority;
+    pxTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+    pxTCB->eState = eReady;
+    pxTCB->pxTaskCode = pxTaskCode;
+    pxTCB->pvParameters = pvParameters;
+
+    pthread_condattr_init( &xCondAttr );
+    pthread_condattr_setclock( &xCondAttr, CLOCK_MONOTONIC );
+    pthread_cond_init( &pxTCB->xWake, &xCondAttr );
+    pthread_condattr_destroy( &xCondAttr );
+
+    prvLock();
+
+    if( prvStartThread( pxTCB ) != 0 )
+    {
+        prvUnlock();
+        pthread_cond_destroy( &pxTCB->xWake );
+        free( pxTCB );
+        return NULL;
+    }
+
+    for( ppxTail = &pxTaskList; *ppxTail != NULL; ppxTail = &( *ppxTail )->pxNext );
+    *ppxTail = pxTCB;
+
+    prvUnlock();
+
+    return pxTCB;
+}
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName,
+                        uint32_t usStackDepth, void * const pvParameters,
+                        UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+    TaskHandle_t xHandle;
+
+    ( void ) usStackDepth;
+
+    xHandle = prvCreateTask( pxTaskCode, pcName, pvParameters, uxPriority );
+    if( pxCreatedTask != NULL )
+        *pxCreatedTask = xHandle;
+
+    return ( xHandle != NULL ) ? pdPASS : errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+}
+
+TaskHandle_t xTaskCreateStatic( TaskFunction_t pxTaskCode, const char * const pcName,
+                                uint32_t ulStackDepth, void * const pvParameters,
+                                UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                                StaticTask_t * const pxTaskBuffer )
+{
+    /* Threads need far larger stacks than the PIC32 tasks, the buffers given
+     * are only checked for presence */
+    ( void ) ulStackDepth;
+
+    if( puxStackBuffer == NULL || pxTaskBuffer == NULL )
+        return NULL;
+
+    return prvCreateTask( pxTaskCode, pcName, pvParameters, uxPriority );
+}
+
+void vTaskDelete( TaskHandle_t xTaskToDelete )
+{
+    struct tskTaskControlBlock *pxTCB;
+
+    prvLock();
+    pxTCB = prvGetTCB( xTaskToDelete );
+
+    if( pxTCB == pxCurrentTCB )
+        prvExitThread( pxTCB );
+
+    /* A thread can not be stopped from outside, it exits at its next call
+     * into the kernel, at once when it is blocked */
+    if( pxTCB->eState != eDeleted )
+    {
+        pxTCB->xDeletePending = pdTRUE;
+        pthread_cond_signal( &pxTCB->xWake );
+        pthread_cond_broadcast( &xStartCond );
+    }
+
+    prvUnlock();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+    return pxCurrentTCB;
+}
+
+char * pcTaskGetName( TaskHandle_t xTaskToQuery )
+{
+    return prvGetTCB( xTaskToQuery )->pcName;
+}
+
+#if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
+void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
+{
+    if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+        prvGetTCB( xTaskToSet )->pvThreadLocalStoragePointers[ xIndex ] = pvValue;
+}
+
+void * pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex )
+{
+    if( xIndex >= configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+        return NULL;
+    return prvGetTCB( xTaskToQuery )->pvThreadLocalStoragePointers[ xIndex ];
+}
+#endif
+
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority )
+{
+    struct tskTaskControlBlock *pxTCB;
+    struct sched_param xParam;
+
+    if( uxNewPriority >= configMAX_PRIORITIES )
+        uxNewPriority = configMAX_PRIORITIES - 1;
+
+    prvLock();
+    pxTCB = prvGetTCB( xTask );
+
+    if( pxTCB->uxPriority != uxNewPriority && pxTCB->eState != eDeleted )
+    {
+        pxTCB->uxPriority = uxNewPriority;
+        if( xRealTime )
+        {
+            memset( &xParam, 0, sizeof( xParam ) );
+            xParam.sched_priority = prvFifoPriority( uxNewPriority );
+            pthread_setschedparam( pxTCB->xThread, SCHED_FIFO, &xParam );
+        }
+    }
+
+    prvUnlock();
+}
+
+UBaseType_t uxTaskPriorityGet( TaskHandle_t xTask )
+{
+    return prvGetTCB( xTask )->uxPriority;
+}
+
+UBaseType_t uxTaskPriorityGetFromISR( TaskHandle_t xTask )
+{
+    return prvGetTCB( xTask )->uxPriority;
+}
+
+#if( configNUM_CORES > 1 && configUSE_CORE_AFFINITY == 1 )
+void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask )
+{
+    struct tskTaskControlBlock *pxTCB;
+
+    prvLock();
+    pxTCB = prvGetTCB( xTask );
+    pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+    if( pxTCB->eState != eDeleted )
+        prvApplyAffinity( pxTCB );
+    prvUnlock();
+}
+
+UBaseType_t vTaskCoreAffinityGet( const TaskHandle_t xTask )
+{
+    return prvGetTCB( xTask )->uxCoreAffinityMask;
+}
+#endif
+
+eTaskState eTaskGetState( TaskHandle_t xTask )
+{
+    struct tskTaskControlBlock *pxTCB = prvGetTCB( xTask );
+
+    if( pxTCB->eState == eReady )
+        return eRunning;
+    return pxTCB->eState;
+}
+
+void vTaskYield( void )
+{
+    sched_yield();
+}
+
+void vTaskStartScheduler( void )
+{
+    struct timespec xEnd;
+
+    prvLock();
+
+    /* Page faults would add to the response times, best effort */
+    if( xRealTime )
+        ( void ) mlockall( MCL_CURRENT | MCL_FUTURE );
+
+    llEpochNs = prvNowNs();
+    xSchedulerRunning = pdTRUE;
+    pthread_cond_broadcast( &xStartCond );
+
+    /* The main thread is not a task, it waits for the end of the run */
+    xEnd = prvTimespec( llEpochNs + ( int64_t ) ullEndTick * posixTICK_NS );
+    while( !xEndRequested )
+    {
+        if( ullEndTick == 0 )
+            pthread_cond_wait( &xEndCond, &xKernelLock );
+        else if( pthread_cond_timedwait( &xEndCond, &xKernelLock, &xEnd ) == ETIMEDOUT )
+            break;
+    }
+
+    /* Returns with the kernel lock held, the tasks stop at their next call
+     * into the kernel and the caller reads a stable state */
+}
+
+void vTaskEndScheduler( void )
+{
+    prvLock();
+    xEndRequested = pdTRUE;
+    pthread_cond_signal( &xEndCond );
+
+    /* Park the calling task, the main thread keeps the lock from now on */
+    if( pxCurrentTCB != NULL )
+        prvBlock( posixWAIT_DELAY, NULL, 0, 0 );
+    prvUnlock();
+}
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+    return xSchedulerRunning ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED;
+}
+
+/*-----------------------------------------------------------*/
+/* Direct to task notifications */
+
+#define posixNOTIFY_NOT_WAITING     ( 0 )
+#define posixNOTIFY_WAITING         ( 1 )
+#define posixNOTIFY_RECEIVED        ( 2 )
+
+static BaseType_t prvNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndex, uint32_t ulValue,
+                             eNotifyAction eAction, uint32_t *pulPrevious )
+{
+    struct tskTaskControlBlock *pxTCB = xTaskToNotify;
+    uint8_t ucOriginalState;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT( pxTCB != NULL && uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+    prvLock();
+
+    if( pulPrevious != NULL )
+        *pulPrevious = pxTCB->ulNotifiedValue[ uxIndex ];
+
+    ucOriginalState = pxTCB->ucNotifyState[ uxIndex ];
+    pxTCB->ucNotifyState[ uxIndex ] = posixNOTIFY_RECEIVED;
+
+    switch( eAction )
+    {
+        case eSetBits:
+            pxTCB->ulNotifiedValue[ uxIndex ] |= ulValue;
+            break;
+        case eIncrement:
+            pxTCB->ulNotifiedValue[ uxIndex ]++;
+            break;
+        case eSetValueWithOverwrite:
+            pxTCB->ulNotifiedValue[ uxIndex ] = ulValue;
+            break;
+        case eSetValueWithoutOverwrite:
+            if( ucOriginalState != posixNOTIFY_RECEIVED )
+                pxTCB->ulNotifiedValue[ uxIndex ] = ulValue;
+            else
+                xReturn = pdFAIL;
+            break;
+        default:
+            break;
+    }
+
+    if( ucOriginalState == posixNOTIFY_WAITING && pxTCB->eState == eBlocked &&
+            pxTCB->eWait == posixWAIT_NOTIFY && pxTCB->uxWaitIndex == uxIndex )
+        prvMakeReady( pxTCB );
+
+    prvUnlock();
+
+    return xReturn;
+}
+
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                               uint32_t ulValue, eNotifyAction eAction,
+                               uint32_t *pulPreviousNotificationValue )
+{
+    return prvNotify( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue );
+}
+
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                      uint32_t ulValue, eNotifyAction eAction,
+                                      uint32_t *pulPreviousNotificationValue,
+                                      BaseType_t *pxHigherPriorityTaskWoken )
+{
+    ( void ) pxHigherPriorityTaskWoken;
+
+    return prvNotify( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue );
+}
+
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                                    BaseType_t *pxHigherPriorityTaskWoken )
+{
+    ( void ) xTaskGenericNotifyFromISR( xTaskToNotify, uxIndexToNotify, 0, eIncrement, NULL,
+                                        pxHigherPriorityTaskWoken );
+}
+
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit,
+                                  TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+    uint32_t ulReturn;
+
+    prvLock();
+
+    if( pxTCB->ulNotifiedValue[ uxIndexToWait ] == 0 && xTicksToWait > 0 )
+    {
+        pxTCB->ucNotifyState[ uxIndexToWait ] = posixNOTIFY_WAITING;
+        prvBlock( posixWAIT_NOTIFY, NULL, uxIndexToWait,
+                  ( xTicksToWait == portMAX_DELAY ) ? 0 : prvTimeout( xTicksToWait ) );
+    }
+
+    ulReturn = pxTCB->ulNotifiedValue[ uxIndexToWait ];
+    if( ulReturn != 0 )
+    {
+        if( xClearCountOnExit )
+            pxTCB->ulNotifiedValue[ uxIndexToWait ] = 0;
+        else
+            pxTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - 1;
+    }
+    pxTCB->ucNotifyState[ uxIndexToWait ] = posixNOTIFY_NOT_WAITING;
+
+    prvUnlock();
+
+    return ulReturn;
+}
+
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry,
+                                   uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue,
+                                   TickType_t xTicksToWait )
+{
+    struct tskTaskControlBlock *pxTCB = pxCurrentTCB;
+    BaseType_t xReturn;
+
+    prvLock();
+
+    if( pxTCB->ucNotifyState[ uxIndexToWait ] != posixNOTIFY_RECEIVED )
+    {
+        pxTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
+        if( xTicksToWait > 0 )
+        {
+            pxTCB->ucNotifyState[ uxIndexToWait ] = posixNOTIFY_WAITING;
+            prvBlock( posixWAIT_NOTIFY, NULL, uxIndexToWait,
+                      ( xTicksToWait == portMAX_DELAY ) ? 0 : prvTimeout( xTicksToWait ) );
+        }
+    }
+
+    if( pulNotificationValue != NULL )
+        *pulNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToWait ];
+
+    if( pxTCB->ucNotifyState[ uxIndexToWait ] != posixNOTIFY_RECEIVED )
+    {
+        xReturn = pdFALSE;
+    }
+    else
+    {
+        pxTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
+        xReturn = pdTRUE;
+    }
+    pxTCB->ucNotifyState[ uxIndexToWait ] = posixNOTIFY_NOT_WAITING;
+
+    prvUnlock();
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+/* Queues and semaphores */
+
+static void prvQueueInit( struct QueueDefinition *pxQueue, UBaseType_t uxQueueLength,
+                          UBaseType_t uxItemSize, UBaseType_t uxInitialCount )
+{
+    pxQueue->uxLength = uxQueueLength;
+    pxQueue->uxItemSize = uxItemSize;
+    pxQueue->uxMessagesWaiting = uxInitialCount;
+    pxQueue->uxReadIndex = 0;
+}
+
+QueueHandle_t xQueueGenericCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                   UBaseType_t uxInitialCount )
+{
+    struct QueueDefinition *pxQueue;
+
+    pxQueue = calloc( 1, sizeof( *pxQueue ) );
+    if( pxQueue == NULL )
+        return NULL;
+
+    if( uxItemSize > 0 )
+    {
+        pxQueue->pucStorage = calloc( uxQueueLength, uxItemSize );
+        if( pxQueue->pucStorage == NULL )
+        {
+            free( pxQueue );
+            return NULL;
+        }
+    }
+
+    prvQueueInit( pxQueue, uxQueueLength, uxItemSize, uxInitialCount );
+    return pxQueue;
+}
+
+QueueHandle_t xQueueGenericCreateStatic( UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                         uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                         UBaseType_t uxInitialCount )
+{
+    struct QueueDefinition *pxQueue;
+
+    if( pxStaticQueue == NULL || ( uxItemSize > 0 && pucQueueStorage == NULL ) )
+        return NULL;
+
+    /* The kernel bookkeeping lives on the host heap, the item storage given
+     * by the caller is used */
+    pxQueue = calloc( 1, sizeof( *pxQueue ) );
+    if( pxQueue == NULL )
+        return NULL;
+
+    pxQueue->pucStorage = pucQueueStorage;
+    pxQueue->ucStaticStorage = 1;
+    prvQueueInit( pxQueue, uxQueueLength, uxItemSize, uxInitialCount );
+    return pxQueue;
+}
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+    if( xQueue == NULL )
+        return;
+    if( !xQueue->ucStaticStorage )
+        free( xQueue->pucStorage );
+    free( xQueue );
+}
+
+static BaseType_t prvQueueCopyIn( struct QueueDefinition *pxQueue, const void *pvItem )
+{
+    UBaseType_t uxWrite;
+
+    if( pxQueue->uxMessagesWaiting >= pxQueue->uxLength )
+        return pdFALSE;
+
+    if( pxQueue->uxItemSize > 0 )
+    {
+        uxWrite = ( pxQueue->uxReadIndex + pxQueue->uxMessagesWaiting ) % pxQueue->uxLength;
+        memcpy( pxQueue->pucStorage + uxWrite * pxQueue->uxItemSize, pvItem, pxQueue->uxItemSize );
+    }
+    pxQueue->uxMessagesWaiting++;
+
+    return pdTRUE;
+}
+
+static BaseType_t prvQueueCopyOut( struct QueueDefinition *pxQueue, void *pvBuffer )
+{
+    if( pxQueue->uxMessagesWaiting == 0 )
+        return pdFALSE;
+
+    if( pxQueue->uxItemSize > 0 )
+    {
+        if( pvBuffer != NULL )
+            memcpy( pvBuffer, pxQueue->pucStorage + pxQueue->uxReadIndex * pxQueue->uxItemSize,
+                    pxQueue->uxItemSize );
+        pxQueue->uxReadIndex = ( pxQueue->uxReadIndex + 1 ) % pxQueue->uxLength;
+    }
+    pxQueue->uxMessagesWaiting--;
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                              TickType_t xTicksToWait )
+{
+    int64_t llDeadline = ( xTicksToWait == portMAX_DELAY ) ? 0 : prvTimeout( xTicksToWait );
+    BaseType_t xReturn;
+
+    prvLock();
+
+    for( ;; )
+    {
+        if( prvQueueCopyIn( xQueue, pvItemToQueue ) )
+        {
+            prvWakeWaiter( posixWAIT_QUEUE_RECEIVE, xQueue );
+            xReturn = pdPASS;
+            break;
+        }
+
+        if( xTicksToWait == 0 || !prvBlock( posixWAIT_QUEUE_SEND, xQueue, 0, llDeadline ) )
+        {
+            xReturn = errQUEUE_FULL;
+            break;
+        }
+    }
+
+    prvUnlock();
+
+    return xReturn;
+}
+
+BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                     BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn = errQUEUE_FULL;
+
+    ( void ) pxHigherPriorityTaskWoken;
+
+    prvLock();
+    if( prvQueueCopyIn( xQueue, pvItemToQueue ) )
+    {
+        prvWakeWaiter( posixWAIT_QUEUE_RECEIVE, xQueue );
+        xReturn = pdPASS;
+    }
+    prvUnlock();
+
+    return xReturn;
+}
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+    int64_t llDeadline = ( xTicksToWait == portMAX_DELAY ) ? 0 : prvTimeout( xTicksToWait );
+    BaseType_t xReturn;
+
+    prvLock();
+
+    for( ;; )
+    {
+        if( prvQueueCopyOut( xQueue, pvBuffer ) )
+        {
+            prvWakeWaiter( posixWAIT_QUEUE_SEND, xQueue );
+            xReturn = pdPASS;
+            break;
+        }
+
+        if( xTicksToWait == 0 || !prvBlock( posixWAIT_QUEUE_RECEIVE, xQueue, 0, llDeadline ) )
+        {
+            xReturn = errQUEUE_EMPTY;
+            break;
+        }
+    }
+
+    prvUnlock();
+
+    return xReturn;
+}
+
+BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer,
+                                 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    ( void ) pxHigherPriorityTaskWoken;
+
+    prvLock();
+    if( prvQueueCopyOut( xQueue, pvBuffer ) )
+    {
+        prvWakeWaiter( posixWAIT_QUEUE_SEND, xQueue );
+        xReturn = pdPASS;
+    }
+    prvUnlock();
+
+    return xReturn;
+}
+
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t xQueue )
+{
+    UBaseType_t uxReturn;
+
+    prvLock();
+    uxReturn = xQueue->uxMessagesWaiting;
+    prvUnlock();
+
+    return uxReturn;
+}
@@ -0,0 +1,465 @@
+/*
+ * authors:
+ * Martim Neves, mec:88904
+ * Daniel Vala Correia, mec:90480
+ *
+ *
+ * Host decoder of the TMAN job event trace.
+ *
+ * Reads the UART output of TMAN_TraceDump, lines that are not part of a
+ * dump are skipped so a whole terminal log can be given, and prints the
+ * jobs of every task followed by a Gantt chart of the trace.
+ *
+ * Usage: tmantrace [-r us_per_column] [-w columns] [dump.txt]
+ *
+ * Chart legend: '#' running, '-' released and not complete, '^' release,
+ * 'X' deadline miss, 'o' release during an overrun, 'C' criticality raised
+ * by the task, '.' idle.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Same values as TMAN_TRACE_* in tman.h */
+#define EV_RELEASE              1
+#define EV_START                2
+#define EV_PRECEDENCE_WAIT      3
+#define EV_COMPLETE             4
+#define EV_MISS                 5
+#define EV_SWITCH_IN            6
+#define EV_SWITCH_OUT           7
+#define EV_OVERRUN              8
+#define EV_CRITICALITY          9
+
+#define MAX_TASKS               256
+#define NAME_LEN                32
+#define DEFAULT_COLUMNS         100
+
+/* Decoded event, time in microseconds since the first event */
+struct Event {
+    uint64_t time;
+    int event;
+    int task;
+    unsigned arg;
+};
+
+/* Job rebuilt from its events, times are UINT64_MAX until seen */
+struct Job {
+    unsigned number;
+    uint64_t release;
+    uint64_t start;
+    uint64_t complete;
+    unsigned lateness;
+    int missed;
+};
+
+struct TaskTrace {
+    char name[NAME_LEN];
+    struct Job *jobs;
+    size_t jobCount;
+    size_t jobSize;
+    /* Releases during an overrun, and those of them that were skipped */
+    unsigned overruns;
+    unsigned skipped;
+    /* Times the task raised the criticality of the system */
+    unsigned raised;
+};
+
+#define NONE                    UINT64_MAX
+
+static struct Event *g_events;
+static size_t g_eventCount, g_eventSize;
+static struct TaskTrace g_tasks[MAX_TASKS];
+static int g_taskCount;
+static unsigned long g_lost;
+static int g_switches;
+
+static void *xrealloc( void *ptr, size_t size )
+{
+    ptr = realloc( ptr, size );
+    if( ptr == NULL )
+    {
+        fprintf( stderr, "tmantrace: out of memory\n" );
+        exit( 1 );
+    }
+    return ptr;
+}
+
+/* Parse a dump, timestamps are unwrapped and converted with the timebase
+ * frequency of the header of each dump */
+static int ReadTrace( FILE *fp )
+{
+    char buffer[256], name[NAME_LEN], *line;
+    unsigned long hz = 0, timestamp, count;
+    unsigned event, task, arg, index;
+    uint64_t high = 0, cycles, first = NONE;
+    uint32_t last = 0;
+    int inDump = 0;
+
+    while( fgets( buffer, sizeof( buffer ), fp ) != NULL )
+    {
+        /* PrintStr lines end in "\n\r", the '\r' starts the next line */
+        line = buffer + strspn( buffer, "\r\n\t " );
+        if( sscanf( line, "TMAN TRACE %lu %lu", &hz, &count ) == 2 )
+        {
+            inDump = ( hz >= 1000000 );
+            continue;
+        }
+        if( !inDump )
+            continue;
+        if( strncmp( line, "TMAN TRACE END", 14 ) == 0 )
+        {
+            inDump = 0;
+            continue;
+        }
+        if( sscanf( line, "TASK %u %31s", &index, name ) == 2 )
+        {
+            if( index < MAX_TASKS )
+            {
+                strcpy( g_tasks[index].name, name );
+                if( ( int ) index >= g_taskCount )
+                    g_taskCount = index + 1;
+            }
+            continue;
+        }
+        if( sscanf( line, "LOST %lu", &count ) == 1 )
+        {
+            g_lost += count;
+            continue;
+        }
+        if( sscanf( line, "%8lx %2x %2x %4x", &timestamp, &event, &task, &arg ) != 4 )
+            continue;
+
+        /* The 32 bit counter wraps, records are in time order */
+        if( ( uint32_t ) timestamp < last )
+            high += 1ULL << 32;
+        last = ( uint32_t ) timestamp;
+        cycles = high + last;
+        if( first == NONE )
+            first = cycles;
+
+        if( g_eventCount == g_eventSize )
+        {
+            g_eventSize = g_eventSize ? 2 * g_eventSize : 1024;
+            g_events = xrealloc( g_events, g_eventSize * sizeof( struct Event ) );
+        }
+        g_events[g_eventCount].time = ( cycles - first ) / ( hz / 1000000 );
+        g_events[g_eventCount].event = event;
+        g_events[g_eventCount].task = task;
+        g_events[g_eventCount].arg = arg;
+        g_eventCount++;
+
+        if( ( int ) task >= g_taskCount )
+            g_taskCount = task + 1;
+        if( event == EV_SWITCH_IN || event == EV_SWITCH_OUT )
+            g_switches = 1;
+    }
+
+    return g_eventCount > 0 ? 0 : -1;
+}
+
+static struct Job *JobFind( struct TaskTrace *pxTask, unsigned number )
+{
+    size_t i;
+    struct Job *pxJob;
+
+    for( i = pxTask->jobCount; i > 0; i-- )
+    {
+        if( pxTask->jobs[i - 1].number == number )
+            return &pxTask->jobs[i - 1];
+    }
+
+    if( pxTask->jobCount == pxTask->jobSize )
+    {
+        pxTask->jobSize = pxTask->jobSize ? 2 * pxTask->jobSize : 64;
+        pxTask->jobs = xrealloc( pxTask->jobs, pxTask->jobSize * sizeof( struct Job ) );
+    }
+    pxJob = &pxTask->jobs[pxTask->jobCount++];
+    pxJob->number = number;
+    pxJob->release = pxJob->start = pxJob->complete = NONE;
+    pxJob->lateness = 0;
+    pxJob->missed = 0;
+
+    return pxJob;
+}
+
+/* A miss belongs to the oldest released job that has not completed */
+static struct Job *JobPending( struct TaskTrace *pxTask )
+{
+    size_t i;
+
+    for( i = 0; i < pxTask->jobCount; i++ )
+    {
+        if( pxTask->jobs[i].release != NONE && pxTask->jobs[i].complete == NONE && !pxTask->jobs[i].missed )
+            return &pxTask->jobs[i];
+    }
+
+    return NULL;
+}
+
+static void BuildJobs( void )
+{
+    size_t i;
+    struct Event *pxEvent;
+    struct TaskTrace *pxTask;
+    struct Job *pxJob;
+
+    for( i = 0; i < g_eventCount; i++ )
+    {
+        pxEvent = &g_events[i];
+        pxTask = &g_tasks[pxEvent->task];
+
+        switch( pxEvent->event )
+        {
+            case EV_RELEASE:
+                pxJob = JobFind( pxTask, pxEvent->arg );
+                pxJob->release = pxEvent->time;
+                break;
+            case EV_START:
+                pxJob = JobFind( pxTask, pxEvent->arg );
+                pxJob->start = pxEvent->time;
+                break;
+            case EV_COMPLETE:
+                pxJob = JobFind( pxTask, pxEvent->arg );
+                pxJob->complete = pxEvent->time;
+                break;
+            case EV_MISS:
+                pxJob = JobPending( pxTask );
+                if( pxJob != NULL )
+                {
+                    pxJob->missed = 1;
+                    pxJob->lateness = pxEvent->arg;
+                }
+                break;
+            case EV_OVERRUN:
+                pxTask->overruns++;
+                if( pxEvent->arg == 0 )
+                    pxTask->skipped++;
+                break;
+            case EV_CRITICALITY:
+                if( pxEvent->arg != 0 )
+                    pxTask->raised++;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void PrintTime( uint64_t time )
+{
+    if( time == NONE )
+        printf( "%12s", "-" );
+    else
+        printf( "%12llu", ( unsigned long long ) time );
+}
+
+static void PrintTimelines( void )
+{
+    int t;
+    size_t i, responses;
+    struct TaskTrace *pxTask;
+    struct Job *pxJob;
+    uint64_t response, minimum, maximum, sum;
+    unsigned misses;
+
+    for( t = 0; t < g_taskCount; t++ )
+    {
+        pxTask = &g_tasks[t];
+        if( pxTask->jobCount == 0 )
+            continue;
+
+        printf( "Task %s (index %d)\n", pxTask->name[0] ? pxTask->name : "?", t );
+        printf( "  %6s %12s %12s %12s %12s\n", "job", "release(us)", "start(us)", "end(us)", "response(us)" );
+
+        responses = 0;
+        misses = 0;
+        minimum = NONE;
+        maximum = 0;
+        sum = 0;
+        for( i = 0; i < pxTask->jobCount; i++ )
+        {
+            pxJob = &pxTask->jobs[i];
+            response = ( pxJob->release != NONE && pxJob->complete != NONE ) ?
+                    pxJob->complete - pxJob->release : NONE;
+
+            printf( "  %6u ", pxJob->number );
+            PrintTime( pxJob->release );
+            printf( " " );
+            PrintTime( pxJob->start );
+            printf( " " );
+            PrintTime( pxJob->complete );
+            printf( " " );
+            PrintTime( response );
+            if( pxJob->missed )
+                printf( "  MISS +%u ticks", pxJob->lateness );
+            printf( "\n" );
+
+            if( response != NONE )
+            {
+                if( response < minimum )
+                    minimum = response;
+                if( response > maximum )
+                    maximum = response;
+                sum += response;
+                responses++;
+            }
+            misses += pxJob->missed;
+        }
+
+        printf( "  jobs %zu, deadline misses %u", pxTask->jobCount, misses );
+        if( responses != 0 )
+            printf( ", response min/avg/max %llu/%llu/%llu us",
+                    ( unsigned long long ) minimum, ( unsigned long long ) ( sum / responses ),
+                    ( unsigned long long ) maximum );
+        if( pxTask->overruns != 0 )
+            printf( ", overruns %u (%u skipped)", pxTask->overruns, pxTask->skipped );
+        if( pxTask->raised != 0 )
+            printf( ", raised the criticality %u times", pxTask->raised );
+        printf( "\n\n" );
+    }
+}
+
+/* Paint [from, to) of a row, an interval shorter than a column still shows */
+static void Paint( char *row, size_t columns, uint64_t resolution, uint64_t from, uint64_t to, char mark )
+{
+    size_t c, first = from / resolution, last = ( to > from ) ? ( to - 1 ) / resolution : first;
+
+    for( c = first; c <= last && c < columns; c++ )
+    {
+        if( row[c] != 'X' && ( mark != '-' || row[c] != '#' ) )
+            row[c] = mark;
+    }
+}
+
+static void PrintGantt( uint64_t resolution, size_t width )
+{
+    uint64_t end = g_events[g_eventCount - 1].time + 1, inSince;
+    size_t columns, c, i;
+    int t;
+    char *row;
+    struct TaskTrace *pxTask;
+    struct Job *pxJob;
+    struct Event *pxEvent;
+
+    if( resolution == 0 )
+        resolution = ( end + width - 1 ) / width;
+    if( resolution == 0 )
+        resolution = 1;
+    columns = ( end + resolution - 1 ) / resolution;
+    row = xrealloc( NULL, columns + 1 );
+
+    printf( "Gantt chart, %llu us per column%s\n", ( unsigned long long ) resolution,
+            g_switches ? "" : ", execution from job start to completion" );
+
+    /* Time axis, one label every 10 columns */
+    printf( "%-8s ", "ms" );
+    for( c = 0; c < columns; c += 10 )
+        printf( "%-10llu", ( unsigned long long ) ( c * resolution / 1000 ) );
+    printf( "\n" );
+
+    for( t = 0; t < g_taskCount; t++ )
+    {
+        pxTask = &g_tasks[t];
+        memset( row, '.', columns );
+        row[columns] = '\0';
+
+        for( i = 0; i < pxTask->jobCount; i++ )
+        {
+            pxJob = &pxTask->jobs[i];
+            if( pxJob->release != NONE )
+                Paint( row, columns, resolution, pxJob->release,
+                        pxJob->complete != NONE ? pxJob->complete : end, '-' );
+            if( !g_switches && pxJob->start != NONE )
+                Paint( row, columns, resolution, pxJob->start,
+                        pxJob->complete != NONE ? pxJob->complete : end, '#' );
+        }
+
+        inSince = NONE;
+        for( i = 0; i < g_eventCount; i++ )
+        {
+            pxEvent = &g_events[i];
+            if( pxEvent->task != t )
+                continue;
+            if( pxEvent->event == EV_SWITCH_IN )
+                inSince = pxEvent->time;
+            else if( pxEvent->event == EV_SWITCH_OUT && inSince != NONE )
+            {
+                Paint( row, columns, resolution, inSince, pxEvent->time, '#' );
+                inSince = NONE;
+            }
+        }
+        if( inSince != NONE )
+            Paint( row, columns, resolution, inSince, end, '#' );
+
+        for( i = 0; i < g_eventCount; i++ )
+        {
+            pxEvent = &g_events[i];
+            if( pxEvent->task != t )
+                continue;
+            c = pxEvent->time / resolution;
+            if( pxEvent->event == EV_MISS )
+                row[c] = 'X';
+            else if( pxEvent->event == EV_OVERRUN && row[c] != 'X' )
+                row[c] = 'o';
+            else if( pxEvent->event == EV_CRITICALITY && pxEvent->arg != 0 && row[c] != 'X' )
+                row[c] = 'C';
+            else if( pxEvent->event == EV_RELEASE && row[c] != '#' && row[c] != 'X' )
+                row[c] = '^';
+        }
+
+        printf( "%-8.8s %s\n", pxTask->name[0] ? pxTask->name : "?", row );
+    }
+
+    free( row );
+}
+
+int main( int argc, char *argv[] )
+{
+    FILE *fp = stdin;
+    uint64_t resolution = 0;
+    size_t width = DEFAULT_COLUMNS;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "r:w:" ) ) != -1 )
+    {
+        switch( opt )
+        {
+            case 'r':
+                resolution = strtoull( optarg, NULL, 10 );
+                break;
+            case 'w':
+                width = strtoul( optarg, NULL, 10 );
+                break;
+            default:
+                fprintf( stderr, "usage: %s [-r us_per_column] [-w columns] [dump.txt]\n", argv[0] );
+                return 1;
+        }
+    }
+    if( width == 0 )
+        width = DEFAULT_COLUMNS;
+
+    if( optind < argc && ( fp = fopen( argv[optind], "r" ) ) == NULL )
+    {
+        perror( argv[optind] );
+        return 1;
+    }
+
+    if( ReadTrace( fp ) != 0 )
+    {
+        fprintf( stderr, "tmantrace: no trace records found\n" );
+        return 1;
+    }
+    if( g_lost != 0 )
+        printf( "Warning: %lu records were overwritten before they were dumped\n\n", g_lost );
+
+    BuildJobs();
+    PrintTimelines();
+    PrintGantt( resolution, width );
+
+    return 0;
+}